@@ -0,0 +1,271 @@
+// HeadlessBoy.cpp : Runs the emulator without display or audio output, as fast as possible.
+//
+
+#include "libdmg.h"
+
+#include "cartridgeloader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#define DEFAULT_FRAMES 3600
+#define AUDIO_FREQUENCY 44100
+#define AUDIO_LATENCY 40
+
+using namespace libdmg;
+using namespace HeadlessBoy;
+
+uint64_t frameCount = 0;
+uint64_t renderedFrameCount = 0;
+
+Memory* memory;
+Video* video;
+AudioStream* audioStream;
+
+bool pumpAudio = false;
+
+bool printSerial = false;
+bool watch = false;
+unsigned int watchStart = 0, watchEnd = 0;
+
+void WatchCallback(uint16_t address, uint8_t value, uint16_t pc, WatchKind kind)
+{
+	// Setting the high bit of the serial control register starts sending the data byte, which is how the test ROMs report their results
+	if (printSerial && address == GB_REG_SC && kind == WATCH_WRITE)
+	{
+		if (READ_BIT(value, 7))
+		{
+			putchar(memory->PeekByte(GB_REG_SB));
+			fflush(stdout);
+		}
+
+		if (!watch || address < watchStart || address > watchEnd)
+			return;
+	}
+
+	Debug::Print("[HeadlessBoy]: %s 0x%02X %s 0x%04X at 0x%04X\n", kind == WATCH_READ ? "Read" : "Wrote", value, kind == WATCH_READ ? "from" : "to", address, pc);
+}
+
+void VBlankCallback()
+{
+	++frameCount;
+
+	if (video->IsFrameRendered())
+		++renderedFrameCount;
+
+	// Files are written on the emulator thread, so no output is lost however fast it runs
+	if (pumpAudio)
+		audioStream->Pump();
+}
+
+void PrintUsage()
+{
+	Debug::Print("Usage: HeadlessBoy <rom file> [-frames <count> | -seconds <duration>] [-output <indexed8 | rgb565 | bgra32>] [-render <all | none | skipped/period>] [-wav <file>] [-timed-dma] [-watch <address>[-<end>]] [-serial]\n");
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	// Parse the run duration, in emulated ticks
+	uint64_t targetTicks = (uint64_t) DEFAULT_FRAMES * GB_FRAME_DURATION;
+
+	// Optionally let the video controller render a host format frame, as a frontend would
+	bool hostOutput = false;
+	Video::OutputFormat outputFormat = Video::OUTPUT_BGRA32;
+
+	// Frames can be skipped to spend the time in the CPU instead
+	Video::RenderPolicy renderPolicy = Video::RENDER_ALL;
+	unsigned int skippedFrames = 0, skipPeriod = 1;
+
+	// Audio is discarded on a consumer thread, unless it is written to a file
+	const char* wavFileName = NULL;
+	bool timedDMA = false;
+
+	for (int argIdx = 2; argIdx < argc; ++argIdx)
+	{
+		if (argIdx + 1 < argc && strcmp(argv[argIdx], "-frames") == 0)
+			targetTicks = strtoull(argv[++argIdx], NULL, 10) * GB_FRAME_DURATION;
+		else if (argIdx + 1 < argc && strcmp(argv[argIdx], "-seconds") == 0)
+			targetTicks = (uint64_t) (strtod(argv[++argIdx], NULL) * GB_CLOCK_FREQUENCY);
+		else if (argIdx + 1 < argc && strcmp(argv[argIdx], "-output") == 0)
+		{
+			const char* format = argv[++argIdx];
+			hostOutput = true;
+
+			if (strcmp(format, "indexed8") == 0)
+				outputFormat = Video::OUTPUT_INDEXED8;
+			else if (strcmp(format, "rgb565") == 0)
+				outputFormat = Video::OUTPUT_RGB565;
+			else if (strcmp(format, "bgra32") == 0)
+				outputFormat = Video::OUTPUT_BGRA32;
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (argIdx + 1 < argc && strcmp(argv[argIdx], "-render") == 0)
+		{
+			const char* policy = argv[++argIdx];
+
+			if (strcmp(policy, "all") == 0)
+				renderPolicy = Video::RENDER_ALL;
+			else if (strcmp(policy, "none") == 0)
+				renderPolicy = Video::RENDER_NONE;
+			else if (sscanf(policy, "%u/%u", &skippedFrames, &skipPeriod) == 2 && skipPeriod > 0 && skipPeriod <= 255 && skippedFrames < skipPeriod)
+				renderPolicy = Video::RENDER_SKIP_FRAMES;
+			else
+			{
+				PrintUsage();
+				return 1;
+			}
+		}
+		else if (argIdx + 1 < argc && strcmp(argv[argIdx], "-wav") == 0)
+			wavFileName = argv[++argIdx];
+		else if (strcmp(argv[argIdx], "-timed-dma") == 0)
+			timedDMA = true;
+		else if (argIdx + 1 < argc && strcmp(argv[argIdx], "-watch") == 0)
+		{
+			const char* range = argv[++argIdx];
+			char* end;
+
+			watchStart = strtoul(range, &end, 16);
+			watchEnd = *end == '-' ? strtoul(end + 1, &end, 16) : watchStart;
+
+			if (*end != '\0' || watchStart > watchEnd || watchEnd > 0xFFFF)
+			{
+				PrintUsage();
+				return 1;
+			}
+
+			watch = true;
+		}
+		else if (strcmp(argv[argIdx], "-serial") == 0)
+			printSerial = true;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	CartridgeLoader cartridgeLoader;
+
+	if (!cartridgeLoader.LoadFile(argv[1]))
+		return 1;
+
+	uint16_t videoBufferSize = GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT / 4;
+	uint8_t* videoBuffer = new uint8_t[videoBufferSize];
+
+	memset(videoBuffer, 0, videoBufferSize);
+
+	memory = new Memory();
+	CPU* cpu = new CPU(*memory);
+	Cartridge* cartridge = new Cartridge(cartridgeLoader.RomBuffer(), cartridgeLoader.CRamBuffer());
+	video = new Video(*cpu, *memory, videoBuffer);
+	Input* input = new Input(*cpu);
+	Audio* audio = new Audio(*memory);
+
+	video->VBlankCallback = VBlankCallback;
+
+	if (renderPolicy == Video::RENDER_SKIP_FRAMES)
+		video->SetFrameSkip((uint8_t) skippedFrames, (uint8_t) skipPeriod);
+	else
+		video->SetRenderPolicy(renderPolicy);
+
+	uint32_t* outputBuffer = new uint32_t[GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT];
+
+	if (hostOutput)
+	{
+		// Grayscale shades, from white to black
+		const uint32_t indexedPalette[] = { 0, 1, 2, 3 };
+		const uint32_t rgb565Palette[] = { 0xFFFF, 0x9CD3, 0x4A49, 0x0000 };
+		const uint32_t bgraPalette[] = { 0xFFFFFFFF, 0xFF999999, 0xFF4C4C4C, 0xFF000000 };
+
+		switch (outputFormat)
+		{
+			case Video::OUTPUT_INDEXED8:	video->SetOutputPalette(indexedPalette); break;
+			case Video::OUTPUT_RGB565:		video->SetOutputPalette(rgb565Palette); break;
+			case Video::OUTPUT_BGRA32:		video->SetOutputPalette(bgraPalette); break;
+		}
+
+		uint8_t bytesPerPixel = outputFormat == Video::OUTPUT_INDEXED8 ? 1 : (outputFormat == Video::OUTPUT_RGB565 ? 2 : 4);
+		video->SetOutputBuffer(reinterpret_cast<uint8_t*>(outputBuffer), outputFormat, GB_SCREEN_WIDTH * bytesPerPixel);
+	}
+
+	AudioSink* audioSink;
+
+	if (wavFileName != NULL)
+		audioSink = new WavFileSink(wavFileName);
+	else
+		audioSink = new NullAudioSink();
+
+	audioStream = new AudioStream(*audio, *audioSink);
+
+	if (!audioStream->Open(AUDIO_FREQUENCY, AUDIO_LATENCY))
+		return 1;
+
+	pumpAudio = wavFileName != NULL;
+
+	if (!pumpAudio)
+		audioStream->Start();
+
+	Emulator* emulator = new Emulator(*cpu, *memory, *cartridge, *video, *audio, *input);
+	emulator->SetDMATimed(timedDMA);
+
+	// Accesses to the watched range are printed as they happen
+	if (watch)
+		memory->AddWatch(watchStart, watchEnd, WATCH_ACCESS);
+
+	if (printSerial)
+		memory->AddWatch(GB_REG_SC, GB_REG_SC, WATCH_WRITE);
+
+	if (watch || printSerial)
+		emulator->WatchCallback = WatchCallback;
+
+	emulator->Boot();
+
+	// Run the emulator in one go, without any host synchronization
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	emulator->Run(targetTicks);
+
+	std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+	if (pumpAudio)
+		audioStream->Pump();
+
+	audioStream->Close();
+
+	double emulatorDuration = emulator->Ticks() / (double) GB_CLOCK_FREQUENCY;
+	double realDuration = std::chrono::duration<double>(endTime - startTime).count();
+
+	Debug::Print("[HeadlessBoy]: Emulated %.2fs (%llu frames, %llu rendered) in %.2fs\n", 
+		emulatorDuration, (unsigned long long) frameCount, (unsigned long long) renderedFrameCount, realDuration);
+
+	Debug::Print("[HeadlessBoy]: Speed: %.1f%%; %.1f frames/s; %.2fM instructions/s\n", 
+		(emulatorDuration / realDuration) * 100, frameCount / realDuration, emulator->InstructionsExecuted() / realDuration / 1000000.0);
+
+	delete emulator;
+	delete audioStream;
+	delete audioSink;
+	delete audio;
+	delete input;
+	delete video;
+	delete cartridge;
+	delete cpu;
+	delete memory;
+
+	delete[] videoBuffer;
+	delete[] outputBuffer;
+
+	return 0;
+}
\ No newline at end of file
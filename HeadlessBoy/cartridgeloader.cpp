@@ -0,0 +1,69 @@
+#include "libdmg.h"
+
+#include "cartridgeloader.h"
+#include "debug.h"
+
+#include <string.h>
+#include <stdio.h>
+
+using namespace HeadlessBoy;
+using namespace libdmg;
+
+CartridgeLoader::CartridgeLoader() : hasSaveFile(false), romSize(0), cramSize(0)
+{
+	romBuffer = new uint8_t[GB_MAX_CARTRIDGE_SIZE];
+	cramBuffer = new uint8_t[GB_MAX_CARTRIDGE_RAM_SIZE];
+
+	// According to SameBoy source, uninitialized MBC RAM should be 0xFF
+	memset(romBuffer, 0x00, GB_MAX_CARTRIDGE_SIZE);
+	memset(cramBuffer, 0xFF, GB_MAX_CARTRIDGE_RAM_SIZE);
+}
+
+CartridgeLoader::~CartridgeLoader()
+{
+	delete[] romBuffer;
+	delete[] cramBuffer;
+}
+
+bool CartridgeLoader::LoadFile(const char* fileName)
+{
+	romFileName = std::string(fileName);
+
+	// Read the ROM file
+	if (!ReadFile(romFileName.c_str(), romBuffer, GB_MAX_CARTRIDGE_SIZE, romSize))
+	{
+		Debug::Print("[HeadlessBoy]: Failed to read ROM file: %s!\n", fileName);
+		return false;
+	}
+
+	Debug::Print("[HeadlessBoy]: Rom file read with %uKB.\n", (uint32_t) (romSize >> 10));
+
+	// Attempt to read the save file, it is never written back so batch runs always start from the same state
+	size_t extensionIdx = romFileName.find_last_of('.');
+	saveFileName = romFileName.substr(0, extensionIdx) + ".sav";
+
+	hasSaveFile = ReadFile(saveFileName.c_str(), cramBuffer, GB_MAX_CARTRIDGE_RAM_SIZE, cramSize);
+
+	if (hasSaveFile)
+		Debug::Print("[CartridgeLoader]: Save file read with %uKB.\n", (uint32_t) (cramSize >> 10));
+	else
+		Debug::Print("[CartridgeLoader]: Save file not found.\n");
+
+	return true;
+}
+
+bool CartridgeLoader::ReadFile(const char* fileName, uint8_t* buffer, size_t bufferSize, size_t& readBytes)
+{
+	// Open a file handle
+	FILE* handle = fopen(fileName, "rb");
+
+	if (handle == NULL)
+		return false;
+
+	// Read the file contents
+	readBytes = fread(buffer, 1, bufferSize, handle);
+
+	fclose(handle);
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef _CARTRIDGE_LOADER_H_
+#define _CARTRIDGE_LOADER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+namespace HeadlessBoy
+{
+	class CartridgeLoader
+	{
+	private:
+		std::string romFileName;
+		std::string saveFileName;
+
+		uint8_t* romBuffer;
+		uint8_t* cramBuffer;
+
+		bool hasSaveFile;
+
+		size_t romSize;
+		size_t cramSize;
+
+	public:
+		CartridgeLoader();
+		~CartridgeLoader();
+
+		bool LoadFile(const char* fileName);
+
+		bool HasSaveFile() const { return hasSaveFile; }
+
+		uint8_t* RomBuffer() { return romBuffer; }
+		uint8_t* CRamBuffer() { return cramBuffer; }
+		const size_t RomSize() const { return romSize; }
+		const size_t CRamSize() const { return cramSize; }
+
+	private:
+		bool ReadFile(const char* fileName, uint8_t* buffer, size_t bufferSize, size_t& readBytes);
+	};
+
+}
+
+#endif
\ No newline at end of file
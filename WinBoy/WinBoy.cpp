@@ -9,6 +9,7 @@
 #include "Window/buffer.h"
 #include "Window/gdibufferallocator.h"
 #include "Window/color.h"
+#include "Window/scaler.h"
 
 #include "inputmanager.h"
 #include "audiooutput.h"
@@ -38,7 +39,13 @@
 
 #define DISASSEMBLY_LENGTH 10
 #define SCALE_FACTOR 2
+#define SCALE_FILTER Scaler::FILTER_NEAREST
 #define MAX_CATCHUP_TIME 1.0
+#define FREEWHEEL_BATCH_TICKS (GB_CLOCK_FREQUENCY / 60)
+#define FAST_FORWARD_SKIPPED_FRAMES 7
+#define FAST_FORWARD_SKIP_PERIOD 8
+#define AUDIO_FREQUENCY 44100
+#define AUDIO_LATENCY 40
 
 using namespace libdmg;
 using namespace WinBoy;
@@ -72,13 +79,14 @@ uint16_t memoryBreakpoints[] =
 };
 
 bool paused = false;
-bool breakpointsEnabled = false;
 
 uint8_t* memoryBuffer;
 
 uint16_t videoBufferSize;
 uint8_t* videoBuffer;
 
+uint32_t* outputBuffer;
+
 CartridgeLoader cartridgeLoader;
 
 Memory* memory;
@@ -92,9 +100,11 @@ Emulator* emulator;
 
 Window* window;
 AudioOutput* audioOutput;
+AudioStream* audioStream;
 
 GDIBufferAllocator* bufferAllocator;
 Buffer* frameBuffer;
+Scaler scaler;
 
 int main()
 {
@@ -104,45 +114,37 @@ int main()
 void DrawFrameBuffer();
 void PauseEmulator();
 
-void MemoryReadCallback(uint16_t address)
+void WatchCallback(uint16_t address, uint8_t value, uint16_t pc, WatchKind kind)
 {
-	if (!breakpointsEnabled)
-		return;
-
-	const CPU::Registers& registers = cpu->GetRegisters();
-
-	for (uint8_t breakpointIdx = 0; breakpointIdx < sizeof(memoryBreakpoints) / sizeof(uint16_t); ++breakpointIdx)
-	{
-		if (address == memoryBreakpoints[breakpointIdx])
-		{
-			Debug::Print("[WinBoy]: Memory read breakpoint for 0x%04X hit at 0x%04X\n", address, registers.pc);
-			PauseEmulator();
-			break;
-		}
-	}
+	Debug::Print("[WinBoy]: Memory %s breakpoint for 0x%04X hit at 0x%04X\n", kind == WATCH_READ ? "read" : "write", address, pc);
+	emulator->RequestBreak();
 }
 
-void MemoryWriteCallback(uint16_t address)
+void EnableBreakpoints(bool enabled)
 {
-	if (!breakpointsEnabled)
-		return;
-
-	const CPU::Registers& registers = cpu->GetRegisters();
+	Breakpoints& emulatorBreakpoints = emulator->GetBreakpoints();
+	emulatorBreakpoints.Clear();
+	memory->ClearWatches();
 
-	for (uint8_t breakpointIdx = 0; breakpointIdx < sizeof(memoryBreakpoints) / sizeof(uint16_t); ++breakpointIdx)
+	// Breakpoints are only set while they are enabled, so they cost nothing otherwise
+	if (enabled)
 	{
-		if (address == memoryBreakpoints[breakpointIdx])
-		{
-			Debug::Print("[WinBoy]: Memory write breakpoint for 0x%04X hit at 0x%04X\n", address, registers.pc);
-			PauseEmulator();
-			break;
-		}
+		for (uint8_t breakpointIdx = 0; breakpointIdx < sizeof(breakpoints) / sizeof(uint16_t); ++breakpointIdx)
+			emulatorBreakpoints.Add(breakpoints[breakpointIdx]);
+
+		for (uint8_t breakpointIdx = 0; breakpointIdx < sizeof(opcodeBreakpoints) / sizeof(uint8_t); ++breakpointIdx)
+			emulatorBreakpoints.AddOpcode(opcodeBreakpoints[breakpointIdx]);
+
+		for (uint8_t breakpointIdx = 0; breakpointIdx < sizeof(memoryBreakpoints) / sizeof(uint16_t); ++breakpointIdx)
+			memory->AddWatch(memoryBreakpoints[breakpointIdx], memoryBreakpoints[breakpointIdx], WATCH_ACCESS);
 	}
 }
 
 void VBlankCallback()
 {
-	DrawFrameBuffer();
+	// Skipped frames leave the previous frame on screen
+	if (video->IsFrameRendered())
+		DrawFrameBuffer();
 	
 	window->ProcessMessages();
 
@@ -157,12 +159,6 @@ void VBlankCallback()
 	input->SetButtonState(Input::BUTTON_DPAD_LEFT, inputManager.GetKey(VK_LEFT));
 	input->SetButtonState(Input::BUTTON_DPAD_RIGHT, inputManager.GetKey(VK_RIGHT));
 	input->SetButtonState(Input::BUTTON_DPAD_UP, inputManager.GetKey(VK_UP));
-	
-	// Update audio output
-	HRESULT result = audioOutput->Update();
-
-	if (result != S_OK)
-		Debug::Print("[WinBoy]: Error updating audio output: 0x%04x\n", result);
 
 	// Check if we need to save the cram
 	if (memory->mbc != NULL && memory->mbc->IsRamDirty())
@@ -176,21 +172,10 @@ void VBlankCallback()
 
 void DrawFrameBuffer()
 {
-	for (uint16_t y = 0; y < GB_SCREEN_HEIGHT; ++y)
-	{
-		for (uint16_t x = 0; x < GB_SCREEN_WIDTH; ++x)
-		{
-			uint16_t pixel = ((GB_SCREEN_HEIGHT - 1 - y) * GB_SCREEN_WIDTH) + x;
-			uint8_t videoByte = videoBuffer[pixel / 4];
-			uint8_t videoBit = (pixel % 4) << 1;
-			uint8_t color = (videoByte >> videoBit) & 0x03;
-
-			for (uint8_t yy = 0; yy < SCALE_FACTOR; ++yy)
-				for (uint8_t xx = 0; xx < SCALE_FACTOR; ++xx)
-					frameBuffer->SetPixel(x * SCALE_FACTOR + xx, y * SCALE_FACTOR + yy, COLORS[color]);
-
-		}
-	}
+	// The video controller already wrote the frame as BGRA pixels, which only need to be scaled.
+	// The GDI buffer is stored bottom-up, so the source is read from the last row upwards.
+	const uint32_t* lastRow = outputBuffer + (GB_SCREEN_HEIGHT - 1) * GB_SCREEN_WIDTH;
+	scaler.Scale(lastRow, GB_SCREEN_WIDTH, GB_SCREEN_HEIGHT, -(int32_t) (GB_SCREEN_WIDTH * sizeof(uint32_t)), *frameBuffer);
 
 	window->DrawBuffer(*frameBuffer, *bufferAllocator);
 }
@@ -220,11 +205,21 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	audio = new Audio(*memory);
 	input = new Input(*cpu);
 
-	memory->MemoryWriteCallback = MemoryWriteCallback;
-	memory->MemoryReadCallback = MemoryReadCallback;
 	video->VBlankCallback = VBlankCallback;
 
+	// Let the video controller render straight to BGRA pixels
+	uint32_t outputPalette[4];
+	for (uint8_t color = 0; color < 4; ++color)
+		Buffer::EncodeColor(COLORS[color], Buffer::BGRA32, reinterpret_cast<uchar*>(&outputPalette[color]));
+
+	outputBuffer = new uint32_t[GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT];
+	memset(outputBuffer, 0, GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT * sizeof(uint32_t));
+
+	video->SetOutputPalette(outputPalette);
+	video->SetOutputBuffer(reinterpret_cast<uint8_t*>(outputBuffer), Video::OUTPUT_BGRA32, GB_SCREEN_WIDTH * sizeof(uint32_t));
+
 	emulator = new Emulator(*cpu, *memory, *cartridge, *video, *audio, *input);
+	emulator->WatchCallback = WatchCallback;
 	emulator->Boot();
 
 	InputManager& inputManager = InputManager::Instance();
@@ -235,18 +230,23 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	bufferAllocator = new GDIBufferAllocator(window->handle);
 
 	frameBuffer = new Buffer(bufferAllocator);
-	frameBuffer->Allocate(GB_SCREEN_WIDTH * SCALE_FACTOR, GB_SCREEN_HEIGHT * SCALE_FACTOR, Buffer::BGR24);
+	frameBuffer->Allocate(GB_SCREEN_WIDTH * SCALE_FACTOR, GB_SCREEN_HEIGHT * SCALE_FACTOR, Buffer::BGRA32);
+
+	scaler.SetFilter(SCALE_FILTER, SCALE_FACTOR);
 
 	window->Show(nCmdShow);
 
-	audioOutput = new AudioOutput(*audio);
-	HRESULT result = audioOutput->Initialize();
-	if (result != S_OK)
+	// Audio is moved to the device on its own thread, which keeps the latency independent of the frame rate
+	audioOutput = new AudioOutput();
+	audioStream = new AudioStream(*audio, *audioOutput);
+	if (!audioStream->Open(AUDIO_FREQUENCY, AUDIO_LATENCY))
 	{
-		Debug::Print("[WinBoy]: Error initializing audio output: 0x%04x\n", result);
+		Debug::Print("[WinBoy]: Error opening audio output\n");
 		return 1;
 	}
 
+	audioStream->Start();
+
 	Video::Mode prevVideoMode = video->CurrentMode();
 	
 	LARGE_INTEGER timerFrequency;
@@ -270,9 +270,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
 			uint64_t startEmulatorTicks = emulator->Ticks();
 
+			video->SetFrameSkip(FAST_FORWARD_SKIPPED_FRAMES, FAST_FORWARD_SKIP_PERIOD);
+
 			// Core loop to update emulator
 			while (inputManager.GetKey('F'))
-				emulator->Tick();
+				emulator->Run(emulator->Ticks() + FREEWHEEL_BATCH_TICKS);
+
+			video->SetRenderPolicy(Video::RENDER_ALL);
 
 			LARGE_INTEGER endTicks;
 			QueryPerformanceCounter(&endTicks);
@@ -325,9 +329,17 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 		}
 
 		if (inputManager.GetKey('P'))
+		{
 			timeScale = 8.0;
+
+			if (video->GetRenderPolicy() == Video::RENDER_ALL)
+				video->SetFrameSkip(FAST_FORWARD_SKIPPED_FRAMES, FAST_FORWARD_SKIP_PERIOD);
+		}
 		else
+		{
 			timeScale = 1.0;
+			video->SetRenderPolicy(Video::RENDER_ALL);
+		}
 
 		if (paused)
 		{
@@ -379,7 +391,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 						if (address % 16 == 0)
 							Debug::Print("0x%04X  ", address);
 
-						uint8_t byte = memory->ReadByte(address);
+						uint8_t byte = memory->PeekByte(address);
 						Debug::Print("0x%02X ", byte);
 
 						if (address % 16 == 15)
@@ -400,13 +412,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
 			if (inputManager.GetKeyDown('E'))
 			{
-				breakpointsEnabled = true;
+				EnableBreakpoints(true);
 				Debug::Print("[WinBoy]: Breakpoints enabled\n");
 			}
 
 			if (inputManager.GetKeyDown('D'))
 			{
-				breakpointsEnabled = false;
+				EnableBreakpoints(false);
 				Debug::Print("[WinBoy]: Breakpoints disabled\n");
 			}
 
@@ -427,54 +439,28 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
 			emulatorTime = emulator->Ticks() / (double)GB_CLOCK_FREQUENCY;
 
-			while (emulatorTime < realTime && !paused)
+			double delta = realTime - emulatorTime;
+			if (delta > MAX_CATCHUP_TIME)
 			{
-				uint64_t cpuTicks = cpu->Ticks();
-				emulator->Tick();
-
-				// Calculate the time since boot for the CPU
-				emulatorTime = emulator->Ticks() / (double)GB_CLOCK_FREQUENCY;
+				realTime = emulatorTime;
+				printf("[WinBoy]: Warning! Emulator was %.2fs behind. Skipping to catch up...\n", delta);
+			}
 
-				double delta = realTime - emulatorTime;
-				if (delta > MAX_CATCHUP_TIME)
-				{
-					realTime = emulatorTime;
-					printf("[WinBoy]: Warning! Emulator was %.2fs behind. Skipping to catch up...\n", delta);
-				}
+			// Breakpoints are tested by the emulator, which stops the run before the instruction at the breakpoint
+			emulator->Run((uint64_t)(realTime * GB_CLOCK_FREQUENCY));
 
-				// Only test for breakpoints if the CPU executed a new instruction, for some instructions this can be once in 16 ticks.
-				if (breakpointsEnabled && cpu->Ticks() != cpuTicks)
-				{
-					// Test for PC breakpoints
-					const CPU::Registers& registers = cpu->GetRegisters();
-					for (uint8_t breakpointIdx = 0; breakpointIdx < sizeof(breakpoints) / sizeof(uint16_t); ++breakpointIdx)
-					{
-						if (registers.pc == breakpoints[breakpointIdx])
-						{
-							Debug::Print("[WinBoy]: Breakpoint hit at 0x%04X\n", registers.pc);
-							PauseEmulator();
-							break;
-						}
-					}
-
-					uint8_t nextOpcode = memory->ReadByte(registers.pc);
-					for (uint8_t breakpointIdx = 0; breakpointIdx < sizeof(opcodeBreakpoints) / sizeof(uint8_t); ++breakpointIdx)
-					{
-						if (nextOpcode == opcodeBreakpoints[breakpointIdx])
-						{
-							Debug::Print("[WinBoy]: Opcode breakpoint hit for 0x%02X at 0x%04X\n", nextOpcode, registers.pc);
-							PauseEmulator();
-							break;
-						}
-					}
-				}
+			if (emulator->BreakpointHit())
+			{
+				Debug::Print("[WinBoy]: Stopped at 0x%04X\n", cpu->ProgramCounter());
+				PauseEmulator();
 			}
 		}
 	}
 
-	audioOutput->Finalize();
+	audioStream->Close();
 
 	delete[] memoryBuffer;
+	delete[] outputBuffer;
 
 	return 0;
 }
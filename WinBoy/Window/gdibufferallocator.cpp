@@ -18,8 +18,8 @@ GDIBufferAllocator::~GDIBufferAllocator()
 
 uint8_t* GDIBufferAllocator::Allocate(const Buffer& buffer)
 {
-	// Only BGR24 encoding is supporte for the GDI buffer
-	assert(buffer.encoding == Buffer::BGR24);
+	// Only BGR24 and BGRA32 encodings are supported for the GDI buffer
+	assert(buffer.encoding == Buffer::BGR24 || buffer.encoding == Buffer::BGRA32);
 
 	bitmapInfo.bmiColors[0].rgbRed		= 255;
 	bitmapInfo.bmiColors[0].rgbGreen	= 255;
@@ -0,0 +1,270 @@
+#include "stdafx.h"
+#include <memory.h>
+
+#include "environment.h"
+
+#ifdef DMG_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "scaler.h"
+#include "buffer.h"
+
+using namespace WinBoy;
+
+Scaler::Scaler() : filter(FILTER_NEAREST), factor(1), intermediate(NULL), intermediateSize(0)
+{
+
+}
+
+Scaler::~Scaler()
+{
+	if (intermediate != NULL)
+		delete[] intermediate;
+}
+
+void Scaler::SetFilter(Filter filter, uint8_t factor)
+{
+	assert(factor % GetFilterFactor(filter) == 0 && "Scale factor should be a multiple of the filter factor.");
+
+	this->filter = filter;
+	this->factor = factor;
+}
+
+uint8_t Scaler::GetFilterFactor(Filter filter)
+{
+	switch (filter)
+	{
+	case FILTER_SCALE2X:
+		return 2;
+
+	case FILTER_SCALE3X:
+		return 3;
+
+	default:
+		return 1;
+	}
+}
+
+void Scaler::Scale(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, uint32_t* dst, int32_t dstPitch)
+{
+	uint8_t filterFactor = GetFilterFactor(filter);
+	uint8_t remainder = factor / filterFactor;
+
+	if (filterFactor == 1)
+	{
+		ScaleNearest(src, width, height, srcPitch, dst, dstPitch, factor);
+		return;
+	}
+
+	// Filter straight into the target when no further scaling is needed
+	uint32_t* filtered = dst;
+	int32_t filteredPitch = dstPitch;
+
+	if (remainder > 1)
+	{
+		uint32_t size = width * height * filterFactor * filterFactor;
+		if (size > intermediateSize)
+		{
+			if (intermediate != NULL)
+				delete[] intermediate;
+
+			intermediate = new uint32_t[size];
+			intermediateSize = size;
+		}
+
+		filtered = intermediate;
+		filteredPitch = width * filterFactor * sizeof(uint32_t);
+	}
+
+	if (filter == FILTER_SCALE2X)
+		Scale2x(src, width, height, srcPitch, filtered, filteredPitch);
+	else
+		Scale3x(src, width, height, srcPitch, filtered, filteredPitch);
+
+	if (remainder > 1)
+		ScaleNearest(filtered, width * filterFactor, height * filterFactor, filteredPitch, dst, dstPitch, remainder);
+}
+
+void Scaler::Scale(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, Buffer& target)
+{
+	assert(target.bpp == 32 && "Scaler requires a 32 bit target buffer.");
+	assert(target.width >= width * factor && target.height >= height * factor);
+
+	Scale(src, width, height, srcPitch, reinterpret_cast<uint32_t*>(target.data), target.stride);
+}
+
+void Scaler::ScaleNearest(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, uint32_t* dst, int32_t dstPitch, uint8_t factor)
+{
+	uint32_t rowSize = width * factor * sizeof(uint32_t);
+
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		// Expand the row horizontally once, and duplicate the result for the remaining rows
+		uint32_t* targetRow = Row(dst, dstPitch, y * factor);
+		ExpandRow(Row(src, srcPitch, y), width, targetRow, factor);
+
+		for (uint8_t yy = 1; yy < factor; ++yy)
+			memcpy(Row(dst, dstPitch, y * factor + yy), targetRow, rowSize);
+	}
+}
+
+void Scaler::ExpandRow(const uint32_t* src, uint32_t width, uint32_t* dst, uint8_t factor)
+{
+	uint32_t x = 0;
+
+#ifdef DMG_SSE2
+	if (factor == 2)
+	{
+		for (; x + 4 <= width; x += 4)
+		{
+			__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2), _mm_unpacklo_epi32(pixels, pixels));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2 + 4), _mm_unpackhi_epi32(pixels, pixels));
+		}
+	}
+	else if (factor == 4)
+	{
+		for (; x + 4 <= width; x += 4)
+		{
+			__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+			__m128i* target = reinterpret_cast<__m128i*>(dst + x * 4);
+
+			_mm_storeu_si128(target + 0, _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 0, 0, 0)));
+			_mm_storeu_si128(target + 1, _mm_shuffle_epi32(pixels, _MM_SHUFFLE(1, 1, 1, 1)));
+			_mm_storeu_si128(target + 2, _mm_shuffle_epi32(pixels, _MM_SHUFFLE(2, 2, 2, 2)));
+			_mm_storeu_si128(target + 3, _mm_shuffle_epi32(pixels, _MM_SHUFFLE(3, 3, 3, 3)));
+		}
+	}
+#endif
+
+	for (; x < width; ++x)
+	{
+		uint32_t pixel = src[x];
+
+		for (uint8_t xx = 0; xx < factor; ++xx)
+			dst[x * factor + xx] = pixel;
+	}
+}
+
+void Scaler::Scale2x(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, uint32_t* dst, int32_t dstPitch)
+{
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		// Neighbours outside of the image are clamped to the edge
+		const uint32_t* row = Row(src, srcPitch, y);
+		const uint32_t* above = y > 0 ? Row(src, srcPitch, y - 1) : row;
+		const uint32_t* below = y < height - 1 ? Row(src, srcPitch, y + 1) : row;
+
+		Scale2xRow(above, row, below, width, Row(dst, dstPitch, y * 2), Row(dst, dstPitch, y * 2 + 1));
+	}
+}
+
+void Scaler::Scale2xRow(const uint32_t* above, const uint32_t* row, const uint32_t* below, uint32_t width, uint32_t* top, uint32_t* bottom)
+{
+	//   B
+	// D E F
+	//   H
+	// Every source pixel E is written as E0 E1 on the top row and E2 E3 on the bottom row.
+	uint32_t x = 0;
+
+	while (x < width)
+	{
+#ifdef DMG_SSE2
+		// Interior pixels have both horizontal neighbours available, which allows four of them to be filtered at once
+		if (x > 0 && x + 5 <= width)
+		{
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(above + x));
+			__m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + x));
+			__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x - 1));
+			__m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+			__m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x + 1));
+
+			__m128i db = _mm_cmpeq_epi32(d, b);
+			__m128i bf = _mm_cmpeq_epi32(b, f);
+			__m128i dh = _mm_cmpeq_epi32(d, h);
+			__m128i hf = _mm_cmpeq_epi32(h, f);
+
+			__m128i m0 = _mm_andnot_si128(_mm_or_si128(bf, dh), db);
+			__m128i m1 = _mm_andnot_si128(_mm_or_si128(db, hf), bf);
+			__m128i m2 = _mm_andnot_si128(_mm_or_si128(db, hf), dh);
+			__m128i m3 = _mm_andnot_si128(_mm_or_si128(bf, dh), hf);
+
+			__m128i e0 = _mm_or_si128(_mm_and_si128(m0, d), _mm_andnot_si128(m0, e));
+			__m128i e1 = _mm_or_si128(_mm_and_si128(m1, f), _mm_andnot_si128(m1, e));
+			__m128i e2 = _mm_or_si128(_mm_and_si128(m2, d), _mm_andnot_si128(m2, e));
+			__m128i e3 = _mm_or_si128(_mm_and_si128(m3, f), _mm_andnot_si128(m3, e));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(top + x * 2), _mm_unpacklo_epi32(e0, e1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(top + x * 2 + 4), _mm_unpackhi_epi32(e0, e1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(bottom + x * 2), _mm_unpacklo_epi32(e2, e3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(bottom + x * 2 + 4), _mm_unpackhi_epi32(e2, e3));
+
+			x += 4;
+			continue;
+		}
+#endif
+
+		uint32_t b = above[x];
+		uint32_t h = below[x];
+		uint32_t e = row[x];
+		uint32_t d = x > 0 ? row[x - 1] : e;
+		uint32_t f = x < width - 1 ? row[x + 1] : e;
+
+		top[x * 2]			= (d == b && b != f && d != h) ? d : e;
+		top[x * 2 + 1]		= (b == f && b != d && f != h) ? f : e;
+		bottom[x * 2]		= (d == h && d != b && h != f) ? d : e;
+		bottom[x * 2 + 1]	= (h == f && h != d && b != f) ? f : e;
+
+		++x;
+	}
+}
+
+void Scaler::Scale3x(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, uint32_t* dst, int32_t dstPitch)
+{
+	// A B C
+	// D E F
+	// G H I
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		const uint32_t* row = Row(src, srcPitch, y);
+		const uint32_t* above = y > 0 ? Row(src, srcPitch, y - 1) : row;
+		const uint32_t* below = y < height - 1 ? Row(src, srcPitch, y + 1) : row;
+
+		uint32_t* targetRows[3] = { Row(dst, dstPitch, y * 3), Row(dst, dstPitch, y * 3 + 1), Row(dst, dstPitch, y * 3 + 2) };
+
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			uint32_t left = x > 0 ? x - 1 : x;
+			uint32_t right = x < width - 1 ? x + 1 : x;
+
+			uint32_t a = above[left], b = above[x], c = above[right];
+			uint32_t d = row[left], e = row[x], f = row[right];
+			uint32_t g = below[left], h = below[x], i = below[right];
+
+			uint32_t* e0 = targetRows[0] + x * 3;
+			uint32_t* e3 = targetRows[1] + x * 3;
+			uint32_t* e6 = targetRows[2] + x * 3;
+
+			if (b != h && d != f)
+			{
+				e0[0] = d == b ? d : e;
+				e0[1] = ((d == b && e != c) || (b == f && e != a)) ? b : e;
+				e0[2] = b == f ? f : e;
+				e3[0] = ((d == b && e != g) || (d == h && e != a)) ? d : e;
+				e3[1] = e;
+				e3[2] = ((b == f && e != i) || (h == f && e != c)) ? f : e;
+				e6[0] = d == h ? d : e;
+				e6[1] = ((d == h && e != i) || (h == f && e != g)) ? h : e;
+				e6[2] = h == f ? f : e;
+			}
+			else
+			{
+				e0[0] = e0[1] = e0[2] = e;
+				e3[0] = e3[1] = e3[2] = e;
+				e6[0] = e6[1] = e6[2] = e;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef _SCALER_H_
+#define _SCALER_H_
+
+#include "WinBoy.h"
+
+namespace WinBoy
+{
+	class Buffer;
+
+	// Upscales 32 bit pixel images by an integer factor.
+	// Pitches are in bytes and may be negative to walk an image bottom-up.
+	class Scaler
+	{
+
+	public:
+		enum Filter
+		{
+			FILTER_NEAREST,
+			FILTER_SCALE2X,		// Scale2x, also known as EPX
+			FILTER_SCALE3X,
+		};
+
+	private:
+		Filter filter;
+		uint8_t factor;
+
+		uint32_t* intermediate;
+		uint32_t intermediateSize;
+
+	public:
+		Scaler();
+		~Scaler();
+
+		// The factor should be a multiple of the filter factor, the remainder is scaled with nearest neighbour
+		void SetFilter(Filter filter, uint8_t factor);
+
+		void Scale(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, uint32_t* dst, int32_t dstPitch);
+		void Scale(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, Buffer& target);
+
+		uint8_t Factor() const { return factor; }
+
+		static uint8_t GetFilterFactor(Filter filter);
+
+		static void ScaleNearest(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, uint32_t* dst, int32_t dstPitch, uint8_t factor);
+		static void Scale2x(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, uint32_t* dst, int32_t dstPitch);
+		static void Scale3x(const uint32_t* src, uint32_t width, uint32_t height, int32_t srcPitch, uint32_t* dst, int32_t dstPitch);
+
+	private:
+		static void ExpandRow(const uint32_t* src, uint32_t width, uint32_t* dst, uint8_t factor);
+		static void Scale2xRow(const uint32_t* above, const uint32_t* row, const uint32_t* below, uint32_t width, uint32_t* top, uint32_t* bottom);
+
+		static WB_INLINE const uint32_t* Row(const uint32_t* base, int32_t pitch, uint32_t y)
+		{
+			return reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(base) + (intptr_t) pitch * y);
+		}
+
+		static WB_INLINE uint32_t* Row(uint32_t* base, int32_t pitch, uint32_t y)
+		{
+			return reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(base) + (intptr_t) pitch * y);
+		}
+	};
+
+}
+
+#endif
\ No newline at end of file
@@ -18,7 +18,7 @@ using namespace libdmg;
 		(punk) = NULL; \
 	} \
 
-AudioOutput::AudioOutput(Audio& audio) : audio(audio),
+AudioOutput::AudioOutput() :
 	enumerator(NULL), device(NULL), audioClient(NULL), renderClient(NULL),
 	volume(NULL), waveFormat(NULL), waveFormatExtensible(NULL)
 {
@@ -37,7 +37,58 @@ AudioOutput::~AudioOutput()
 	SAFE_RELEASE(volume);
 }
 
-HRESULT AudioOutput::Initialize()
+uint32_t AudioOutput::Open(uint32_t preferredFrequency, uint32_t latency)
+{
+	HRESULT hr = Initialize(preferredFrequency, latency);
+
+	if (hr != S_OK)
+	{
+		Debug::Print("[AudioOutput]: Error initializing audio output: 0x%04x\n", hr);
+		return 0;
+	}
+
+	return waveFormat->nSamplesPerSec;
+}
+
+void AudioOutput::Close()
+{
+	// Stop playing.
+	HRESULT hr = audioClient->Stop();
+
+	if (FAILED(hr))
+		Debug::Print("[AudioOutput]: Error stopping audio output: 0x%04x\n", hr);
+}
+
+uint32_t AudioOutput::Writable()
+{
+	UINT32 numFramesPadding;
+
+	// See how much buffer space is available.
+	HRESULT hr = audioClient->GetCurrentPadding(&numFramesPadding);
+
+	if (FAILED(hr))
+		return 0;
+
+	return bufferFrameCount - numFramesPadding;
+}
+
+void AudioOutput::Write(const AudioFrame* frames, uint32_t count)
+{
+	BYTE* data;
+
+	HRESULT hr = renderClient->GetBuffer(count, &data);
+
+	if (SUCCEEDED(hr))
+	{
+		LoadData(frames, count, data);
+		hr = renderClient->ReleaseBuffer(count, 0);
+	}
+
+	if (FAILED(hr))
+		Debug::Print("[AudioOutput]: Error writing audio output: 0x%04x\n", hr);
+}
+
+HRESULT AudioOutput::Initialize(uint32_t frequency, uint32_t latency)
 {
 	HRESULT hr;
 
@@ -58,13 +109,14 @@ HRESULT AudioOutput::Initialize()
 	waveFormat->wFormatTag = WAVE_FORMAT_PCM;
 	waveFormat->cbSize = sizeof(WAVEFORMATEX);
 	waveFormat->nChannels = 2;
-	waveFormat->nSamplesPerSec = 44100;
+	waveFormat->nSamplesPerSec = frequency;
 	waveFormat->wBitsPerSample = 16;
 
 	waveFormat->nBlockAlign = waveFormat->wBitsPerSample / 8 * waveFormat->nChannels;
 	waveFormat->nAvgBytesPerSec = waveFormat->wBitsPerSample / 8 * waveFormat->nChannels * waveFormat->nSamplesPerSec;
 
-	REFERENCE_TIME bufferDuration = 500 * 1000 * 10;
+	// The device buffers half of the latency, the other half is spent in the output buffer of the emulator
+	REFERENCE_TIME bufferDuration = latency * 1000 * 10 / 2;
 
 #ifdef USE_EXCLUSIVE_MODE
 	hr = audioClient->IsFormatSupported(AUDCLNT_SHAREMODE_EXCLUSIVE, waveFormat, NULL);
@@ -96,9 +148,6 @@ HRESULT AudioOutput::Initialize()
 	EXIT_ON_ERROR(hr);
 #endif
 
-	// Set the output frequency of the audio subsystem
-	audio.SetOutputFrequency(waveFormat->nSamplesPerSec);
-
 	// Get the actual size of the allocated buffer.
 	hr = audioClient->GetBufferSize(&bufferFrameCount);
 	EXIT_ON_ERROR(hr);
@@ -119,71 +168,20 @@ HRESULT AudioOutput::Initialize()
 	return hr;
 }
 
-HRESULT AudioOutput::Update()
+HRESULT AudioOutput::LoadData(const AudioFrame* frames, UINT32 numFrames, BYTE* data)
 {
-	BYTE* data;
-	DWORD flags = 0;
-	UINT32 numFramesPadding;
-
-	HRESULT hr;
-
-	// See how much buffer space is available.
-	hr = audioClient->GetCurrentPadding(&numFramesPadding);
-	EXIT_ON_ERROR(hr);
-
-	UINT32 numFramesAvailable = bufferFrameCount - numFramesPadding;
-
-	// Grab all the available space in the shared buffer.
-	hr = renderClient->GetBuffer(numFramesAvailable, &data);
-	EXIT_ON_ERROR(hr);
-
-	// Attempt to fill the buffer
-	hr = LoadData(numFramesAvailable, data, &flags);
-	EXIT_ON_ERROR(hr);
-
-	hr = renderClient->ReleaseBuffer(numFramesAvailable, flags);
-	EXIT_ON_ERROR(hr);
-
-	return hr;
-}
-
-HRESULT AudioOutput::Finalize()
-{
-	// Stop playing.
-	HRESULT hr = audioClient->Stop();
-	EXIT_ON_ERROR(hr);
-
-	return hr;
-}
-
-HRESULT AudioOutput::LoadData(UINT32 numFrames, BYTE* data, DWORD* flags)
-{
-	//return LoadSine(numFrames, data, flags);
-
-	RingBuffer& outputBuffer = audio.GetOutputBuffer();
 	uint8_t bytesPerSample = waveFormat->wBitsPerSample / 8;
 
-	if (outputBuffer.Length() < 2 || numFrames == 0)
-	{
-		*flags = AUDCLNT_BUFFERFLAGS_SILENT;
-		return S_OK;
-	}
-
-	while (outputBuffer.Length() >= 2 && numFrames > 0)
+	// Convert the frames to the device format
+	for (uint32_t frameIdx = 0; frameIdx < numFrames; ++frameIdx)
 	{
-		for (uint32_t channel = 0; channel < 2; ++channel)
-		{
-			float sample = outputBuffer.ReadByte() / 255.0f;
-			sample = (sample - 0.5f) * 2.0f;
-
-			WriteSample(sample, waveFormat->wBitsPerSample, data);
-			data += bytesPerSample;
-		}
+		WriteSample(frames[frameIdx].left / 32768.0f, waveFormat->wBitsPerSample, data);
+		data += bytesPerSample;
 
-		--numFrames;
+		WriteSample(frames[frameIdx].right / 32768.0f, waveFormat->wBitsPerSample, data);
+		data += bytesPerSample;
 	}
 
-	*flags = 0;
 	return S_OK;
 }
 
@@ -14,7 +14,8 @@ using namespace libdmg;
 
 namespace WinBoy
 {
-	class AudioOutput
+	// Plays the audio output through WASAPI, in the mix format of the default device when it doesn't support 16 bit PCM
+	class AudioOutput : public AudioSink
 	{
 	private:
 		const CLSID CLSID_MMDeviceEnumerator = __uuidof(MMDeviceEnumerator);
@@ -35,18 +36,21 @@ namespace WinBoy
 
 		UINT32 bufferFrameCount;
 
-		Audio& audio;
-
 	public:
-		AudioOutput(Audio& audio);
+		AudioOutput();
 		~AudioOutput();
 
-		HRESULT Initialize();
-		HRESULT Update();
-		HRESULT Finalize();
+		uint32_t Open(uint32_t preferredFrequency, uint32_t latency);
+		void Close();
+
+		uint32_t Writable();
+		void Write(const AudioFrame* frames, uint32_t count);
+
+		bool IsRealTime() const { return true; }
 
 	private:
-		HRESULT LoadData(UINT32 numFrames, BYTE* data, DWORD* flags);
+		HRESULT Initialize(uint32_t frequency, uint32_t latency);
+		HRESULT LoadData(const AudioFrame* frames, UINT32 numFrames, BYTE* data);
 		HRESULT LoadSine(UINT32 numFrames, BYTE* data, DWORD* flags);
 
 		void WriteSample(float sample, WORD bitsPerSample, BYTE* buffer);
@@ -8,52 +8,147 @@
 using namespace libdmg;
 
 Audio::Audio(Memory& memory) : memory(memory),
+	volumeRegister(memory, GB_REG_NR50), terminalSelectRegister(memory, GB_REG_NR51), stateRegister(memory, GB_REG_NR52),
 	outputBuffer(BUFFER_SIZE),
 	sound1(true), sound2(false),
-	samplePeriod(128), sampleTimer(0.0f),
-	ticks(0), frameSequencerTicks(0)
+	ticks(0), frameSequencerTicks(0),
+	sampleBuffer(NULL), requestedFrequency(0)
 {
+	SetOutputFrequency(GB_CLOCK_FREQUENCY / 128);
+}
 
+Audio::~Audio()
+{
+	if (sampleBuffer != NULL)
+	{
+		delete[] sampleBuffer;
+		sampleBuffer = NULL;
+	}
 }
 
 void Audio::Reset()
 {
 	ticks = 0;
 	frameSequencerTicks = 0;
+
+	terminals[0].Clear();
+	terminals[1].Clear();
+
+	sound1.ResetTerminals();
+	sound2.ResetTerminals();
 }
 
 void Audio::Sync(const uint64_t& targetTicks)
 {
+	const uint32_t period = GB_CLOCK_FREQUENCY / GB_FRAME_SEQUENCER_PERIOD;
+
+	ApplyRequestedFrequency();
+
 	while (ticks < targetTicks)
-		Step();
+	{
+		if ((ticks % period) == 0)
+			StepFrameSequencer();
+
+		// Registers only change in between syncs, so the channels run unchanged until the next frame sequencer step
+		uint64_t blockEnd = std::min(targetTicks, (ticks / period + 1) * period);
+		SynthesizeBlock((uint32_t) (blockEnd - ticks));
+	}
+}
+
+uint64_t Audio::NextEvent() const
+{
+	// The frame sequencer is stepped at the start of every period
+	const uint32_t period = GB_CLOCK_FREQUENCY / GB_FRAME_SEQUENCER_PERIOD;
+	
+	return ((ticks + period - 1) / period) * period + 1;
 }
 
 void Audio::SetOutputFrequency(uint32_t frequency)
 {
-	samplePeriod = GB_CLOCK_FREQUENCY / (float) frequency;
+	const uint32_t period = GB_CLOCK_FREQUENCY / GB_FRAME_SEQUENCER_PERIOD;
+
+	outputFrequency = frequency;
+	adjustedFrequency = frequency;
+	requestedFrequency.store(frequency, std::memory_order_relaxed);
+
+	// Every block is synthesized as a frame, which is at most a frame sequencer period long
+	uint32_t maxFrequency = frequency + frequency / MAX_FREQUENCY_ADJUSTMENT;
+	uint32_t frameSamples = (uint32_t) ((uint64_t) period * maxFrequency / GB_CLOCK_FREQUENCY) + 1;
+
+	for (uint8_t terminal = 0; terminal < 2; ++terminal)
+	{
+		terminals[terminal].Allocate(frameSamples);
+		terminals[terminal].SetRates(GB_CLOCK_FREQUENCY, frequency);
+	}
+
+	sound1.ResetTerminals();
+	sound2.ResetTerminals();
+
+	if (sampleBuffer != NULL)
+		delete[] sampleBuffer;
+
+	sampleBuffer = new AudioFrame[frameSamples];
 }
 
 uint32_t Audio::GetOutputFrequency() const 
 {
-	return GB_CLOCK_FREQUENCY / samplePeriod; 
+	return outputFrequency;
 }
 
-void Audio::Step()
+void Audio::AdjustOutputFrequency(uint32_t frequency)
 {
-	if ((((uint32_t) ticks) % (GB_CLOCK_FREQUENCY / GB_FRAME_SEQUENCER_PERIOD)) == 0)
-		StepFrameSequencer();
+	requestedFrequency.store(frequency, std::memory_order_relaxed);
+}
 
-	sound1.StepFrequency();
-	sound2.StepFrequency();
-	
-	++sampleTimer;
-	if (sampleTimer > samplePeriod)
-	{
-		SampleOutput();
-		sampleTimer -= samplePeriod;
-	}
+void Audio::ApplyRequestedFrequency()
+{
+	uint32_t frequency = requestedFrequency.load(std::memory_order_relaxed);
+
+	if (frequency == adjustedFrequency)
+		return;
+
+	// The terminals only have room for frames up to the largest adjustment
+	uint32_t maxAdjustment = outputFrequency / MAX_FREQUENCY_ADJUSTMENT;
+	frequency = std::min(std::max(frequency, outputFrequency - maxAdjustment), outputFrequency + maxAdjustment);
+
+	terminals[0].SetRates(GB_CLOCK_FREQUENCY, frequency);
+	terminals[1].SetRates(GB_CLOCK_FREQUENCY, frequency);
+
+	adjustedFrequency = frequency;
+}
+
+void Audio::SynthesizeBlock(uint32_t length)
+{
+	uint8_t NR50 = *volumeRegister;
+	uint8_t NR51 = *terminalSelectRegister;
+	uint8_t NR52 = *stateRegister;
+
+	bool chipEnabled = READ_BIT(NR52, 7);
+
+	// Volume of every channel on the S01 and S02 terminals, muted if the channel isn't routed to it
+	uint8_t S01Volume = chipEnabled ? (NR50 & 0x07) : 0;
+	uint8_t S02Volume = chipEnabled ? ((NR50 >> 4) & 0x07) : 0;
 
-	++ticks;
+	uint8_t sound1Gains[] = { READ_BIT(NR51, 0) ? S01Volume : (uint8_t) 0, READ_BIT(NR51, 4) ? S02Volume : (uint8_t) 0 };
+	uint8_t sound2Gains[] = { READ_BIT(NR51, 1) ? S01Volume : (uint8_t) 0, READ_BIT(NR51, 5) ? S02Volume : (uint8_t) 0 };
+
+	sound1.Synthesize(terminals, sound1Gains, 0, length);
+	sound2.Synthesize(terminals, sound2Gains, 0, length);
+
+	terminals[0].EndFrame(length);
+	terminals[1].EndFrame(length);
+
+	ticks += length;
+
+	// Interleave the terminals into the output, S01 is the right channel and S02 the left one.
+	// The output only receives samples while the chip is enabled.
+	uint32_t samples = terminals[0].SamplesAvailable();
+
+	terminals[0].ReadSamples(&sampleBuffer[0].right, samples, 2, SAMPLE_GAIN_BITS);
+	terminals[1].ReadSamples(&sampleBuffer[0].left, samples, 2, SAMPLE_GAIN_BITS);
+
+	if (chipEnabled)
+		outputBuffer.Write(sampleBuffer, samples);
 }
 
 void Audio::StepFrameSequencer()
@@ -74,68 +169,12 @@ void Audio::StepFrameSequencer()
 		sound1.StepSweep();
 	
 	// Update the state register
-	uint8_t state = memory.ReadByte(GB_REG_NR52) & 0xF0;
+	uint8_t state = *stateRegister & 0xF0;
 	state = SET_BIT_IF(state, 0, sound1.Enabled());
 	state = SET_BIT_IF(state, 1, sound2.Enabled());
 
-	memory.WriteByte(GB_REG_NR52, state);
+	stateRegister = state;
 
 	// Increase the sequencer tick count
 	++frameSequencerTicks;
-}
-
-void Audio::SampleOutput()
-{
-	uint8_t NR50 = memory.ReadByte(GB_REG_NR50);
-	uint8_t NR51 = memory.ReadByte(GB_REG_NR51);
-	uint8_t NR52 = memory.ReadByte(GB_REG_NR52);
-
-	// Check if the audio chip is enabled
-	if (READ_BIT(NR52, 7))
-	{
-		uint8_t S01 = 127;
-		uint8_t S02 = 127;
-
-		// Extract volumes from NR50 register
-		uint8_t S01Volume = NR50 & 0x07;
-		uint8_t S02Volume = (NR50 >> 4) & 0x07;
-		
-		// Route sound channel outputs to S01 and S02
-		if (sound1.Enabled() && READ_BIT(NR51, 0))
-		{
-			if (sound1.GetOutput())
-				S01 += sound1.GetVolume() * S01Volume;
-			else
-				S01 -= sound1.GetVolume() * S01Volume;
-		}
-
-		if (sound1.Enabled() && READ_BIT(NR51, 4))
-		{
-			if (sound1.GetOutput())
-				S02 += sound1.GetVolume() * S02Volume;
-			else
-				S02 -= sound1.GetVolume() * S02Volume;
-		}
-
-		if (sound2.Enabled() && READ_BIT(NR51, 1))
-		{
-			if (sound2.GetOutput())
-				S01 += sound2.GetVolume() * S01Volume;
-			else
-				S01 -= sound2.GetVolume() * S01Volume;
-		}
-
-		if (sound2.Enabled() && READ_BIT(NR51, 5))
-		{
-			if (sound2.GetOutput())
-				S02 += sound2.GetVolume() * S02Volume;
-			else
-				S02 -= sound2.GetVolume() * S02Volume;
-		}
-
-		outputBuffer.WriteByte(S01);
-		outputBuffer.WriteByte(S02);
-
-		//assert(!outputBuffer.Full());
-	}
 }
\ No newline at end of file
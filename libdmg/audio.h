@@ -3,6 +3,10 @@
 
 #include "tonegenerator.h"
 #include "ringbuffer.h"
+#include "blipbuffer.h"
+#include "memorypointer.h"
+
+#include <atomic>
 
 namespace libdmg
 {
@@ -11,41 +15,66 @@ namespace libdmg
 	class Audio
 	{
 
+	public:
+		// Adjusted output frequencies are kept within 1/MAX_FREQUENCY_ADJUSTMENT of the output frequency
+		static const uint32_t MAX_FREQUENCY_ADJUSTMENT = 100;
+
 	private:
-		const uint16_t BUFFER_SIZE = 0xFFFF;
+		const uint32_t BUFFER_SIZE = 0x8000;
+
+		// Terminal levels are scaled up to 16 bit samples, which leaves room for both channels at full volume
+		const uint8_t SAMPLE_GAIN_BITS = 7;
 
 		Memory& memory;
 
+		MemoryPointer volumeRegister;
+		MemoryPointer terminalSelectRegister;
+		MemoryPointer stateRegister;
+
 		bool enabled;
 
 		uint64_t ticks;
 		uint32_t frameSequencerTicks;
 		
-		float sampleTimer;
-		float samplePeriod;
+		uint32_t outputFrequency;
+
+		// Frequency the terminals currently run at, and the one requested by the consumer of the output
+		uint32_t adjustedFrequency;
+		std::atomic<uint32_t> requestedFrequency;
 
 		ToneGenerator sound1, sound2;
 
+		// Band-limited synthesis for the S01 and S02 output terminals
+		BlipBuffer terminals[2];
+		AudioFrame* sampleBuffer;
+
 		RingBuffer outputBuffer;
 
 	public:
 		Audio(Memory& memory);
+		~Audio();
 
 		void Reset();
 		void Sync(const uint64_t& targetTicks);
 
+		uint64_t NextEvent() const;
+
 		void SetOutputFrequency(uint32_t frequency);
 		uint32_t GetOutputFrequency() const;
 
+		// Slightly speeds up or slows down the output to follow its consumer, without disturbing the buffered output.
+		// This can be called from the thread consuming the output, it is applied at the next sync.
+		void AdjustOutputFrequency(uint32_t frequency);
+
 		ToneGenerator* Sound1() { return &sound1; }
 		ToneGenerator* Sound2() { return &sound2; }
 
 		RingBuffer& GetOutputBuffer() { return outputBuffer; }
 
 	private:
-		void Step();
+		void ApplyRequestedFrequency();
+		void SynthesizeBlock(uint32_t length);
 		void StepFrameSequencer();
-		void SampleOutput();
 	};
 }
 
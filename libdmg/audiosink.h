@@ -0,0 +1,42 @@
+#ifndef _AUDIO_SINK_H_
+#define _AUDIO_SINK_H_
+
+#include "environment.h"
+#include "ringbuffer.h"
+
+namespace libdmg
+{
+	// Destination for the frames produced by Audio, fed by an AudioStream
+	class AudioSink
+	{
+	public:
+		virtual ~AudioSink() { }
+
+		// Prepares the sink for output, returns the frequency it runs at or 0 if it failed.
+		// The latency is the amount of audio in milliseconds that the sink should buffer at most.
+		virtual uint32_t Open(uint32_t preferredFrequency, uint32_t latency) = 0;
+		virtual void Close() = 0;
+
+		// Number of frames that can be written without blocking
+		virtual uint32_t Writable() = 0;
+		virtual void Write(const AudioFrame* frames, uint32_t count) = 0;
+
+		// Whether the frames are played back in real time, which the output frequency has to follow
+		virtual bool IsRealTime() const = 0;
+	};
+
+	// Discards all output
+	class NullAudioSink : public AudioSink
+	{
+	public:
+		uint32_t Open(uint32_t preferredFrequency, uint32_t latency) { return preferredFrequency; }
+		void Close() { }
+
+		uint32_t Writable() { return UINT32_MAX; }
+		void Write(const AudioFrame* frames, uint32_t count) { }
+
+		bool IsRealTime() const { return false; }
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "audiostream.h"
+
+#include <chrono>
+
+#include "audio.h"
+#include "debug.h"
+
+using namespace libdmg;
+
+// Weight of every new buffer measurement in the running average used by the rate control
+#define RATE_CONTROL_SMOOTHING 0.005f
+
+// Time the thread waits when there is nothing to move
+#define IDLE_SLEEP_DURATION std::chrono::milliseconds(1)
+
+AudioStream::AudioStream(Audio& audio, AudioSink& sink) : audio(audio), sink(sink),
+	running(false), frequency(0), targetFrames(0), averageFrames(0.0f)
+{
+
+}
+
+AudioStream::~AudioStream()
+{
+	Close();
+}
+
+bool AudioStream::Open(uint32_t preferredFrequency, uint32_t latency)
+{
+	frequency = sink.Open(preferredFrequency, latency);
+
+	if (frequency == 0)
+		return false;
+
+	audio.SetOutputFrequency(frequency);
+
+	// Half of the latency is spent in the output buffer, the other half in the sink
+	targetFrames = frequency * latency / 2000;
+	averageFrames = 0.0f;
+
+	return true;
+}
+
+void AudioStream::Close()
+{
+	Stop();
+
+	if (frequency != 0)
+	{
+		sink.Close();
+		frequency = 0;
+	}
+}
+
+void AudioStream::Start()
+{
+	assert(frequency != 0 && !running);
+
+	running.store(true, std::memory_order_release);
+	thread = std::thread(&AudioStream::Run, this);
+}
+
+void AudioStream::Stop()
+{
+	if (!running)
+		return;
+
+	running.store(false, std::memory_order_release);
+	thread.join();
+
+	audio.AdjustOutputFrequency(frequency);
+}
+
+uint32_t AudioStream::Pump()
+{
+	RingBuffer& outputBuffer = audio.GetOutputBuffer();
+	uint32_t frameCount = 0;
+
+	if (sink.IsRealTime())
+		UpdateRate();
+
+	while (true)
+	{
+		uint32_t count = outputBuffer.Read(frames, std::min(sink.Writable(), (uint32_t) BATCH_SIZE));
+
+		if (count == 0)
+			break;
+
+		sink.Write(frames, count);
+		frameCount += count;
+	}
+
+	return frameCount;
+}
+
+void AudioStream::Run()
+{
+	while (running.load(std::memory_order_acquire))
+	{
+		if (Pump() == 0)
+			std::this_thread::sleep_for(IDLE_SLEEP_DURATION);
+	}
+}
+
+void AudioStream::UpdateRate()
+{
+	// Smooth out the bursts in which the emulator fills the buffer
+	uint32_t bufferedFrames = audio.GetOutputBuffer().Length();
+	averageFrames += (bufferedFrames - averageFrames) * RATE_CONTROL_SMOOTHING;
+
+	// Produce less when the buffer runs above its target, and more when it runs below
+	float error = (averageFrames - targetFrames) / std::max(targetFrames, 1U);
+	error = std::min(std::max(error, -1.0f), 1.0f);
+
+	float maxAdjustment = frequency / (float) MAX_RATE_ADJUSTMENT;
+	audio.AdjustOutputFrequency((uint32_t) (frequency - error * maxAdjustment + 0.5f));
+}
\ No newline at end of file
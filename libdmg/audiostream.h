@@ -0,0 +1,59 @@
+#ifndef _AUDIO_STREAM_H_
+#define _AUDIO_STREAM_H_
+
+#include "environment.h"
+#include "audiosink.h"
+
+#include <atomic>
+#include <thread>
+
+namespace libdmg
+{
+	class Audio;
+
+	// Moves the output of Audio to a sink, either on a dedicated thread or when pumped by the caller.
+	// For real time sinks the output frequency is adjusted to keep the output buffer at half the latency,
+	// which absorbs the bursts in which the emulator runs without letting the latency grow.
+	class AudioStream
+	{
+	public:
+		static const uint32_t BATCH_SIZE = 512;
+
+		// Largest deviation from the output frequency used by the rate control, as a fraction of it
+		static const uint32_t MAX_RATE_ADJUSTMENT = 200;
+
+	private:
+		Audio& audio;
+		AudioSink& sink;
+
+		std::thread thread;
+		std::atomic<bool> running;
+
+		uint32_t frequency;
+		uint32_t targetFrames;
+		float averageFrames;
+
+		AudioFrame frames[BATCH_SIZE];
+
+	public:
+		AudioStream(Audio& audio, AudioSink& sink);
+		~AudioStream();
+
+		// Opens the sink with the given latency in milliseconds, and sets the output frequency of the audio to match
+		bool Open(uint32_t preferredFrequency, uint32_t latency);
+		void Close();
+
+		// Starts moving the output on a dedicated thread
+		void Start();
+		void Stop();
+
+		// Moves everything the sink accepts on the calling thread, returns the number of frames moved
+		uint32_t Pump();
+
+	private:
+		void Run();
+		void UpdateRate();
+	};
+}
+
+#endif
\ No newline at end of file
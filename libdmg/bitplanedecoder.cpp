@@ -0,0 +1,191 @@
+#include "bitplanedecoder.h"
+
+#ifdef DMG_SSE2
+	#include <immintrin.h>
+
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+#endif
+
+using namespace libdmg;
+
+// Every kernel works on 16 bit lanes holding the lower plane in the low byte and the upper plane in the high byte:
+// 1) The palette is applied on the planes, by selecting the bits of each color with the masks of the pixels using it.
+// 2) The bits in both bytes are reversed, since the leftmost pixel is stored in the highest bit.
+// 3) A perfect shuffle interleaves the lower and upper plane into 2 bit pixels.
+
+BitplaneDecoder::BitplaneDecoder()
+{
+	kernel = DecodeScalar;
+
+#ifdef DMG_SSE2
+	kernel = SupportsAVX2() ? DecodeAVX2 : DecodeSSE2;
+#endif
+}
+
+void BitplaneDecoder::DecodeScalar(const uint8_t* planes, uint16_t* pixels, uint16_t rowCount, uint8_t palette)
+{
+	// Bits of every palette color, expanded to a byte mask
+	uint8_t colorMasks[4][2];
+
+	for (uint8_t color = 0; color < 4; ++color)
+	{
+		colorMasks[color][0] = ((palette >> (color << 1)) & 0x01) ? 0xFF : 0x00;
+		colorMasks[color][1] = ((palette >> (color << 1)) & 0x02) ? 0xFF : 0x00;
+	}
+
+	for (uint16_t row = 0; row < rowCount; ++row)
+	{
+		uint8_t lower = planes[(row << 1) + 0];
+		uint8_t upper = planes[(row << 1) + 1];
+
+		uint8_t pixelMasks[4] = { (uint8_t) (~lower & ~upper), (uint8_t) (lower & ~upper), (uint8_t) (~lower & upper), (uint8_t) (lower & upper) };
+
+		uint8_t mappedLower = 0, mappedUpper = 0;
+
+		for (uint8_t color = 0; color < 4; ++color)
+		{
+			mappedLower |= pixelMasks[color] & colorMasks[color][0];
+			mappedUpper |= pixelMasks[color] & colorMasks[color][1];
+		}
+
+		uint16_t x = mappedLower | (mappedUpper << 8);
+
+		x = ((x & 0xF0F0) >> 4) | ((x & 0x0F0F) << 4);
+		x = ((x & 0xCCCC) >> 2) | ((x & 0x3333) << 2);
+		x = ((x & 0xAAAA) >> 1) | ((x & 0x5555) << 1);
+
+		uint16_t t;
+		t = (x ^ (x >> 4)) & 0x00F0; x ^= t ^ (t << 4);
+		t = (x ^ (x >> 2)) & 0x0C0C; x ^= t ^ (t << 2);
+		t = (x ^ (x >> 1)) & 0x2222; x ^= t ^ (t << 1);
+
+		pixels[row] = x;
+	}
+}
+
+#ifdef DMG_SSE2
+
+void BitplaneDecoder::DecodeSSE2(const uint8_t* planes, uint16_t* pixels, uint16_t rowCount, uint8_t palette)
+{
+	__m128i colorMasks[4];
+
+	for (uint8_t color = 0; color < 4; ++color)
+	{
+		uint16_t mask = ((palette >> (color << 1)) & 0x01) ? 0x00FF : 0x0000;
+		mask |= ((palette >> (color << 1)) & 0x02) ? 0xFF00 : 0x0000;
+
+		colorMasks[color] = _mm_set1_epi16((short) mask);
+	}
+
+	const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+
+	uint16_t row = 0;
+
+	for (; row + 8 <= rowCount; row += 8)
+	{
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes + (row << 1)));
+
+		// Copy each plane to both bytes of its lane, so the pixel masks can be applied to the color masks of both planes
+		__m128i lower = _mm_and_si128(x, lowBytes);
+		__m128i upper = _mm_srli_epi16(x, 8);
+
+		lower = _mm_or_si128(lower, _mm_slli_epi16(lower, 8));
+		upper = _mm_or_si128(upper, _mm_slli_epi16(upper, 8));
+
+		x = _mm_and_si128(_mm_andnot_si128(lower, _mm_andnot_si128(upper, _mm_set1_epi8(-1))), colorMasks[0]);
+		x = _mm_or_si128(x, _mm_and_si128(_mm_andnot_si128(upper, lower), colorMasks[1]));
+		x = _mm_or_si128(x, _mm_and_si128(_mm_andnot_si128(lower, upper), colorMasks[2]));
+		x = _mm_or_si128(x, _mm_and_si128(_mm_and_si128(lower, upper), colorMasks[3]));
+
+		x = _mm_or_si128(_mm_srli_epi16(_mm_and_si128(x, _mm_set1_epi16((short) 0xF0F0)), 4), _mm_slli_epi16(_mm_and_si128(x, _mm_set1_epi16(0x0F0F)), 4));
+		x = _mm_or_si128(_mm_srli_epi16(_mm_and_si128(x, _mm_set1_epi16((short) 0xCCCC)), 2), _mm_slli_epi16(_mm_and_si128(x, _mm_set1_epi16(0x3333)), 2));
+		x = _mm_or_si128(_mm_srli_epi16(_mm_and_si128(x, _mm_set1_epi16((short) 0xAAAA)), 1), _mm_slli_epi16(_mm_and_si128(x, _mm_set1_epi16(0x5555)), 1));
+
+		__m128i t;
+		t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi16(x, 4)), _mm_set1_epi16(0x00F0));
+		x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_slli_epi16(t, 4)));
+		t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi16(x, 2)), _mm_set1_epi16(0x0C0C));
+		x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_slli_epi16(t, 2)));
+		t = _mm_and_si128(_mm_xor_si128(x, _mm_srli_epi16(x, 1)), _mm_set1_epi16(0x2222));
+		x = _mm_xor_si128(x, _mm_xor_si128(t, _mm_slli_epi16(t, 1)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + row), x);
+	}
+
+	DecodeScalar(planes + (row << 1), pixels + row, rowCount - row, palette);
+}
+
+DMG_TARGET_AVX2 void BitplaneDecoder::DecodeAVX2(const uint8_t* planes, uint16_t* pixels, uint16_t rowCount, uint8_t palette)
+{
+	__m256i colorMasks[4];
+
+	for (uint8_t color = 0; color < 4; ++color)
+	{
+		uint16_t mask = ((palette >> (color << 1)) & 0x01) ? 0x00FF : 0x0000;
+		mask |= ((palette >> (color << 1)) & 0x02) ? 0xFF00 : 0x0000;
+
+		colorMasks[color] = _mm256_set1_epi16((short) mask);
+	}
+
+	const __m256i lowBytes = _mm256_set1_epi16(0x00FF);
+
+	uint16_t row = 0;
+
+	for (; row + 16 <= rowCount; row += 16)
+	{
+		__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes + (row << 1)));
+
+		__m256i lower = _mm256_and_si256(x, lowBytes);
+		__m256i upper = _mm256_srli_epi16(x, 8);
+
+		lower = _mm256_or_si256(lower, _mm256_slli_epi16(lower, 8));
+		upper = _mm256_or_si256(upper, _mm256_slli_epi16(upper, 8));
+
+		x = _mm256_and_si256(_mm256_andnot_si256(lower, _mm256_andnot_si256(upper, _mm256_set1_epi8(-1))), colorMasks[0]);
+		x = _mm256_or_si256(x, _mm256_and_si256(_mm256_andnot_si256(upper, lower), colorMasks[1]));
+		x = _mm256_or_si256(x, _mm256_and_si256(_mm256_andnot_si256(lower, upper), colorMasks[2]));
+		x = _mm256_or_si256(x, _mm256_and_si256(_mm256_and_si256(lower, upper), colorMasks[3]));
+
+		x = _mm256_or_si256(_mm256_srli_epi16(_mm256_and_si256(x, _mm256_set1_epi16((short) 0xF0F0)), 4), _mm256_slli_epi16(_mm256_and_si256(x, _mm256_set1_epi16(0x0F0F)), 4));
+		x = _mm256_or_si256(_mm256_srli_epi16(_mm256_and_si256(x, _mm256_set1_epi16((short) 0xCCCC)), 2), _mm256_slli_epi16(_mm256_and_si256(x, _mm256_set1_epi16(0x3333)), 2));
+		x = _mm256_or_si256(_mm256_srli_epi16(_mm256_and_si256(x, _mm256_set1_epi16((short) 0xAAAA)), 1), _mm256_slli_epi16(_mm256_and_si256(x, _mm256_set1_epi16(0x5555)), 1));
+
+		__m256i t;
+		t = _mm256_and_si256(_mm256_xor_si256(x, _mm256_srli_epi16(x, 4)), _mm256_set1_epi16(0x00F0));
+		x = _mm256_xor_si256(x, _mm256_xor_si256(t, _mm256_slli_epi16(t, 4)));
+		t = _mm256_and_si256(_mm256_xor_si256(x, _mm256_srli_epi16(x, 2)), _mm256_set1_epi16(0x0C0C));
+		x = _mm256_xor_si256(x, _mm256_xor_si256(t, _mm256_slli_epi16(t, 2)));
+		t = _mm256_and_si256(_mm256_xor_si256(x, _mm256_srli_epi16(x, 1)), _mm256_set1_epi16(0x2222));
+		x = _mm256_xor_si256(x, _mm256_xor_si256(t, _mm256_slli_epi16(t, 1)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + row), x);
+	}
+
+	DecodeSSE2(planes + (row << 1), pixels + row, rowCount - row, palette);
+}
+
+bool BitplaneDecoder::SupportsAVX2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+
+	if (info[0] < 7)
+		return false;
+
+	// The OS has to save the YMM registers on context switches
+	__cpuid(info, 1);
+
+	if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x06) != 0x06)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef _BITPLANE_DECODER_H_
+#define _BITPLANE_DECODER_H_
+
+#include "environment.h"
+
+namespace libdmg
+{
+	// Converts tile rows from the planar 2 bit format in VRAM to packed, palette mapped pixels.
+	// Every row is read as its lower and upper plane byte, and written as 8 pixels with the leftmost pixel in the lowest 2 bits.
+	class BitplaneDecoder
+	{
+	public:
+		typedef void (*Kernel)(const uint8_t* planes, uint16_t* pixels, uint16_t rowCount, uint8_t palette);
+
+	private:
+		Kernel kernel;
+
+	public:
+		BitplaneDecoder();
+
+		DMG_INLINE void Decode(const uint8_t* planes, uint16_t* pixels, uint16_t rowCount, uint8_t palette) const
+		{
+			kernel(planes, pixels, rowCount, palette);
+		}
+
+		static void DecodeScalar(const uint8_t* planes, uint16_t* pixels, uint16_t rowCount, uint8_t palette);
+
+#ifdef DMG_SSE2
+		static void DecodeSSE2(const uint8_t* planes, uint16_t* pixels, uint16_t rowCount, uint8_t palette);
+		static void DecodeAVX2(const uint8_t* planes, uint16_t* pixels, uint16_t rowCount, uint8_t palette);
+#endif
+
+	private:
+		static bool SupportsAVX2();
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "blipbuffer.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "debug.h"
+
+using namespace libdmg;
+
+// Cutoff of the low-pass filter, relative to the output frequency
+#define BLIP_CUTOFF 0.45
+
+// Steps used to integrate the impulse response over each output sample
+#define BLIP_INTEGRATION_STEPS 16
+
+BlipBuffer::BlipBuffer() : samples(NULL), capacity(0), available(0), factor(0), offset(0), integrator(0)
+{
+	BuildKernel();
+}
+
+BlipBuffer::~BlipBuffer()
+{
+	if (samples != NULL)
+	{
+		delete[] samples;
+		samples = NULL;
+	}
+}
+
+void BlipBuffer::Allocate(uint32_t frameSamples)
+{
+	if (samples != NULL)
+		delete[] samples;
+
+	// Room for the samples of a complete frame, plus the kernel tail of its last delta
+	capacity = frameSamples + KERNEL_WIDTH;
+	samples = new int32_t[capacity];
+
+	Clear();
+}
+
+void BlipBuffer::SetRates(uint32_t clockRate, uint32_t sampleRate)
+{
+	factor = ((uint64_t) sampleRate << 32) / clockRate;
+}
+
+void BlipBuffer::Clear()
+{
+	available = 0;
+	offset = 0;
+	integrator = 0;
+
+	if (samples != NULL)
+		memset(samples, 0, capacity * sizeof(int32_t));
+}
+
+void BlipBuffer::AddDelta(uint32_t time, int32_t delta)
+{
+	uint64_t position = offset + time * factor;
+
+	uint32_t sample = available + (uint32_t) (position >> 32);
+	uint8_t phase = (uint8_t) (position >> (32 - PHASE_BITS)) & (PHASE_COUNT - 1);
+
+	assert(sample + KERNEL_WIDTH <= capacity);
+
+	int32_t* target = samples + sample;
+	const int32_t* step = kernel[phase];
+
+	for (uint8_t tap = 0; tap < KERNEL_WIDTH; ++tap)
+		target[tap] += step[tap] * delta;
+}
+
+void BlipBuffer::EndFrame(uint32_t length)
+{
+	offset += length * factor;
+
+	// Deltas of the next frame start after this point, so the samples before it are complete
+	available += (uint32_t) (offset >> 32);
+	offset &= 0xFFFFFFFF;
+
+	assert(available + KERNEL_WIDTH <= capacity);
+}
+
+void BlipBuffer::ReadSamples(int16_t* target, uint32_t count, uint8_t stride, uint8_t gainBits)
+{
+	assert(count <= available);
+	assert(gainBits < KERNEL_BITS);
+
+	const uint8_t shift = KERNEL_BITS - gainBits;
+
+	for (uint32_t sample = 0; sample < count; ++sample)
+	{
+		integrator += samples[sample];
+
+		int32_t value = (integrator + (1 << (shift - 1))) >> shift;
+		target[sample * stride] = (int16_t) std::min(std::max(value, (int32_t) INT16_MIN), (int32_t) INT16_MAX);
+	}
+
+	// Move the remaining samples and kernel tails to the front
+	memmove(samples, samples + count, (capacity - count) * sizeof(int32_t));
+	memset(samples + capacity - count, 0, count * sizeof(int32_t));
+
+	available -= count;
+}
+
+void BlipBuffer::BuildKernel()
+{
+	const double pi = 3.14159265358979323846;
+	const double halfWidth = KERNEL_WIDTH / 2;
+
+	for (uint8_t phase = 0; phase < PHASE_COUNT; ++phase)
+	{
+		// Position of the step within its output sample
+		double stepOffset = phase / (double) PHASE_COUNT;
+
+		double taps[KERNEL_WIDTH];
+		double sum = 0.0;
+
+		for (uint8_t tap = 0; tap < KERNEL_WIDTH; ++tap)
+		{
+			// Every tap receives the part of the windowed sinc impulse that falls within its sample.
+			// The first tap is half the kernel before the step, which delays the output by that amount.
+			double start = tap - halfWidth - stepOffset;
+			double area = 0.0;
+
+			for (uint8_t step = 0; step < BLIP_INTEGRATION_STEPS; ++step)
+			{
+				double t = start + (step + 0.5) / BLIP_INTEGRATION_STEPS;
+
+				if (t <= -halfWidth || t >= halfWidth)
+					continue;
+
+				double x = 2.0 * BLIP_CUTOFF * t;
+				double sinc = x == 0.0 ? 1.0 : sin(pi * x) / (pi * x);
+
+				// Blackman window over the width of the kernel
+				double w = (t + halfWidth) / KERNEL_WIDTH;
+				double window = 0.42 - 0.5 * cos(2.0 * pi * w) + 0.08 * cos(4.0 * pi * w);
+
+				area += 2.0 * BLIP_CUTOFF * sinc * window;
+			}
+
+			taps[tap] = area / BLIP_INTEGRATION_STEPS;
+			sum += taps[tap];
+		}
+
+		// Normalize, and give the rounding error to the center tap so every step adds up to exactly one unit
+		int32_t total = 0;
+
+		for (uint8_t tap = 0; tap < KERNEL_WIDTH; ++tap)
+		{
+			kernel[phase][tap] = (int32_t) floor(taps[tap] / sum * (1 << KERNEL_BITS) + 0.5);
+			total += kernel[phase][tap];
+		}
+
+		kernel[phase][KERNEL_WIDTH / 2] += (1 << KERNEL_BITS) - total;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef _BLIP_BUFFER_H_
+#define _BLIP_BUFFER_H_
+
+#include "environment.h"
+
+namespace libdmg
+{
+	// Band-limited step synthesis buffer, in the style of Blip_Buffer.
+	// Level changes are added as deltas at clock times within a frame, each spread over the output samples with a band-limited step kernel.
+	// Integrating the deltas gives the waveform resampled at the output frequency, without the aliasing of point sampling.
+	class BlipBuffer
+	{
+	public:
+		static const uint8_t PHASE_BITS = 5;
+		static const uint8_t PHASE_COUNT = 1 << PHASE_BITS;
+
+		static const uint8_t KERNEL_WIDTH = 16;
+
+		// Fixed point precision of the kernel, a delta of one adds up to exactly one unit
+		static const uint8_t KERNEL_BITS = 15;
+
+	private:
+		int32_t kernel[PHASE_COUNT][KERNEL_WIDTH];
+
+		int32_t* samples;
+		uint32_t capacity;
+		uint32_t available;
+
+		// Output samples per clock, and the position of the frame start, both 32.32 fixed point
+		uint64_t factor;
+		uint64_t offset;
+
+		int32_t integrator;
+
+	public:
+		BlipBuffer();
+		~BlipBuffer();
+
+		// Makes room for frames producing up to the given number of samples, and clears the buffer
+		void Allocate(uint32_t frameSamples);
+
+		// The rates can be changed at any time without clearing the buffer, as long as the frames still fit
+		void SetRates(uint32_t clockRate, uint32_t sampleRate);
+		void Clear();
+
+		void AddDelta(uint32_t time, int32_t delta);
+
+		// Ends the frame after the given number of clocks, which makes the samples before its end available
+		void EndFrame(uint32_t length);
+
+		uint32_t SamplesAvailable() const { return available; }
+
+		// Writes samples scaled up by the given number of bits, with the given stride to interleave channels
+		void ReadSamples(int16_t* target, uint32_t count, uint8_t stride, uint8_t gainBits);
+
+	private:
+		void BuildKernel();
+	};
+}
+
+#endif
\ No newline at end of file
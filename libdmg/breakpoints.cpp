@@ -0,0 +1,197 @@
+#include "breakpoints.h"
+
+#include <string.h>
+
+#include "debug.h"
+
+using namespace libdmg;
+
+const Breakpoints::Condition Breakpoints::ALWAYS = { Breakpoints::Condition::REG_NONE, Breakpoints::Condition::COMPARE_EQUAL, 0 };
+
+bool Breakpoints::Condition::Test(const CPU& cpu) const
+{
+	const CPU::Registers& registers = cpu.PeekRegisters();
+	uint16_t registerValue;
+
+	switch (reg)
+	{
+		case REG_A:		registerValue = registers.a; break;
+		case REG_F:		registerValue = cpu.GetRegisters().f; break;
+		case REG_B:		registerValue = registers.b; break;
+		case REG_C:		registerValue = registers.c; break;
+		case REG_D:		registerValue = registers.d; break;
+		case REG_E:		registerValue = registers.e; break;
+		case REG_H:		registerValue = registers.h; break;
+		case REG_L:		registerValue = registers.l; break;
+		case REG_AF:	registerValue = cpu.GetRegisters().af; break;
+		case REG_BC:	registerValue = registers.bc; break;
+		case REG_DE:	registerValue = registers.de; break;
+		case REG_HL:	registerValue = registers.hl; break;
+		case REG_SP:	registerValue = registers.sp; break;
+
+		default:
+			return true;
+	}
+
+	switch (comparison)
+	{
+		case COMPARE_EQUAL:		return registerValue == value;
+		case COMPARE_NOT_EQUAL:	return registerValue != value;
+		case COMPARE_LESS:		return registerValue < value;
+		case COMPARE_GREATER:	return registerValue > value;
+
+		default:
+			assert(false);
+			return false;
+	}
+}
+
+Breakpoints::Breakpoints()
+{
+	for (uint16_t bank = 0; bank < MAX_ROM_BANKS; ++bank)
+		bankBits[bank] = NULL;
+
+	Clear();
+}
+
+Breakpoints::~Breakpoints()
+{
+	for (uint16_t bank = 0; bank < MAX_ROM_BANKS; ++bank)
+	{
+		if (bankBits[bank] != NULL)
+		{
+			delete[] bankBits[bank];
+			bankBits[bank] = NULL;
+		}
+	}
+}
+
+bool Breakpoints::Add(uint16_t address, uint16_t bank, const Condition& condition)
+{
+	if (breakpointCount == MAX_BREAKPOINTS)
+		return false;
+
+	// Only the switchable ROM area maps different banks at the same address
+	if (!InBankArea(address))
+		bank = ANY_BANK;
+
+	if (bank != ANY_BANK)
+	{
+		if (bank >= MAX_ROM_BANKS)
+			return false;
+
+		if (bankBits[bank] == NULL)
+		{
+			bankBits[bank] = new uint32_t[BANK_AREA_SIZE / 32];
+			memset(bankBits[bank], 0, BANK_AREA_SIZE / 8);
+		}
+	}
+
+	breakpoints[breakpointCount++] = { address, bank, condition };
+	UpdateAddressBit(address, bank);
+
+	return true;
+}
+
+void Breakpoints::Remove(uint16_t address, uint16_t bank)
+{
+	if (!InBankArea(address))
+		bank = ANY_BANK;
+
+	for (uint8_t breakpointIdx = 0; breakpointIdx < breakpointCount; )
+	{
+		if (breakpoints[breakpointIdx].address == address && breakpoints[breakpointIdx].bank == bank)
+			breakpoints[breakpointIdx] = breakpoints[--breakpointCount];
+		else
+			++breakpointIdx;
+	}
+
+	UpdateAddressBit(address, bank);
+}
+
+void Breakpoints::AddOpcode(uint8_t opcode, bool prefixed)
+{
+	if (TestOpcode(opcode, prefixed))
+		return;
+
+	uint16_t index = (prefixed ? 256 : 0) + opcode;
+	opcodeBits[index >> 5] |= 1U << (index & 0x1F);
+
+	++opcodeCount;
+}
+
+void Breakpoints::RemoveOpcode(uint8_t opcode, bool prefixed)
+{
+	if (!TestOpcode(opcode, prefixed))
+		return;
+
+	uint16_t index = (prefixed ? 256 : 0) + opcode;
+	opcodeBits[index >> 5] &= ~(1U << (index & 0x1F));
+
+	--opcodeCount;
+}
+
+void Breakpoints::Clear()
+{
+	breakpointCount = 0;
+	opcodeCount = 0;
+
+	memset(addressBits, 0, sizeof(addressBits));
+	memset(opcodeBits, 0, sizeof(opcodeBits));
+
+	// The bank bitmaps are kept for later breakpoints
+	for (uint16_t bank = 0; bank < MAX_ROM_BANKS; ++bank)
+	{
+		if (bankBits[bank] != NULL)
+			memset(bankBits[bank], 0, BANK_AREA_SIZE / 8);
+	}
+}
+
+bool Breakpoints::TestRange(uint16_t start, uint16_t end, uint16_t romBank) const
+{
+	for (uint32_t address = start; address <= end; ++address)
+	{
+		if (TestAddress((uint16_t) address, romBank))
+			return true;
+	}
+
+	return false;
+}
+
+bool Breakpoints::Test(uint16_t address, uint16_t romBank, const CPU& cpu) const
+{
+	uint16_t bank = InBankArea(address) ? romBank : ANY_BANK;
+
+	for (uint8_t breakpointIdx = 0; breakpointIdx < breakpointCount; ++breakpointIdx)
+	{
+		const Breakpoint& breakpoint = breakpoints[breakpointIdx];
+
+		if (breakpoint.address != address)
+			continue;
+
+		if (breakpoint.bank != ANY_BANK && breakpoint.bank != bank)
+			continue;
+
+		if (breakpoint.condition.Test(cpu))
+			return true;
+	}
+
+	return false;
+}
+
+void Breakpoints::UpdateAddressBit(uint16_t address, uint16_t bank)
+{
+	bool set = false;
+
+	for (uint8_t breakpointIdx = 0; breakpointIdx < breakpointCount; ++breakpointIdx)
+		set |= breakpoints[breakpointIdx].address == address && breakpoints[breakpointIdx].bank == bank;
+
+	// Breakpoints in a single bank are kept in the bitmap of that bank, relative to the start of the area
+	uint32_t* bits = bank != ANY_BANK ? bankBits[bank] : addressBits;
+	uint16_t index = bank != ANY_BANK ? address - BANK_AREA_START : address;
+
+	if (set)
+		bits[index >> 5] |= 1U << (index & 0x1F);
+	else
+		bits[index >> 5] &= ~(1U << (index & 0x1F));
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef _BREAKPOINTS_H_
+#define _BREAKPOINTS_H_
+
+#include "environment.h"
+
+#include "cpu.h"
+
+namespace libdmg
+{
+	// Breakpoints on program counter values and opcodes, tested by the emulator before every instruction while any are set.
+	// Bitmaps over the address space and the opcodes filter out the instructions without a breakpoint.
+	// Breakpoints in a single bank of the switchable ROM area are kept in a bitmap for that bank, so the bitmaps only hit
+	// at breakpoints in the code that is actually mapped. Only the conditions are looked up after a hit.
+	class Breakpoints
+	{
+	public:
+		static const uint8_t MAX_BREAKPOINTS = 64;
+		static const uint16_t MAX_ROM_BANKS = 512;
+
+		// Matches the address in every ROM bank, addresses outside the switchable ROM area always use it
+		static const uint16_t ANY_BANK = 0xFFFF;
+
+		// Predicate over a register of the CPU, a breakpoint with a condition only breaks while it holds
+		struct Condition
+		{
+			enum Register
+			{
+				REG_NONE,
+				REG_A, REG_F, REG_B, REG_C, REG_D, REG_E, REG_H, REG_L,
+				REG_AF, REG_BC, REG_DE, REG_HL, REG_SP,
+			};
+
+			enum Comparison
+			{
+				COMPARE_EQUAL,
+				COMPARE_NOT_EQUAL,
+				COMPARE_LESS,
+				COMPARE_GREATER,
+			};
+
+			Register reg;
+			Comparison comparison;
+			uint16_t value;
+
+			// Only reads the register it compares, so the flags are only computed for conditions on F
+			bool Test(const CPU& cpu) const;
+		};
+
+		static const Condition ALWAYS;
+
+	private:
+		static const uint16_t BANK_AREA_START = 0x4000;
+		static const uint16_t BANK_AREA_SIZE = 0x4000;
+
+		struct Breakpoint
+		{
+			uint16_t address;
+			uint16_t bank;
+			Condition condition;
+		};
+
+		Breakpoint breakpoints[MAX_BREAKPOINTS];
+		uint8_t breakpointCount;
+
+		// Breakpoints that match any bank, and those in a single bank of the switchable ROM area.
+		// The bank bitmaps are allocated when a breakpoint is first added to their bank.
+		uint32_t addressBits[0x10000 / 32];
+		uint32_t* bankBits[MAX_ROM_BANKS];
+
+		// Prefixed opcodes are stored in the upper half
+		uint32_t opcodeBits[512 / 32];
+		uint16_t opcodeCount;
+
+	public:
+		Breakpoints();
+		~Breakpoints();
+
+		// Returns false if there is no room for the breakpoint, or the bank doesn't exist
+		bool Add(uint16_t address, uint16_t bank = ANY_BANK, const Condition& condition = ALWAYS);
+		void Remove(uint16_t address, uint16_t bank = ANY_BANK);
+
+		void AddOpcode(uint8_t opcode, bool prefixed = false);
+		void RemoveOpcode(uint8_t opcode, bool prefixed = false);
+
+		void Clear();
+
+		bool Empty() const { return breakpointCount == 0 && opcodeCount == 0; }
+		bool HasOpcodes() const { return opcodeCount > 0; }
+
+		// Whether there is a breakpoint at the address, with the given bank mapped in the switchable ROM area
+		DMG_INLINE bool TestAddress(uint16_t address, uint16_t romBank) const
+		{
+			if (TestBit(addressBits, address))
+				return true;
+
+			if (!InBankArea(address))
+				return false;
+
+			const uint32_t* bits = romBank < MAX_ROM_BANKS ? bankBits[romBank] : NULL;
+			return bits != NULL && TestBit(bits, address - BANK_AREA_START);
+		}
+
+		DMG_INLINE bool TestOpcode(uint8_t opcode, bool prefixed) const
+		{
+			uint16_t index = (prefixed ? 256 : 0) + opcode;
+			return (opcodeBits[index >> 5] & (1U << (index & 0x1F))) != 0;
+		}
+
+		// Whether any address in the range, including the end, holds a breakpoint
+		bool TestRange(uint16_t start, uint16_t end, uint16_t romBank) const;
+
+		// Tests the conditions of the breakpoints at an address that passed TestAddress
+		bool Test(uint16_t address, uint16_t romBank, const CPU& cpu) const;
+
+	private:
+		DMG_INLINE static bool TestBit(const uint32_t* bits, uint16_t index)
+		{
+			return (bits[index >> 5] & (1U << (index & 0x1F))) != 0;
+		}
+
+		DMG_INLINE static bool InBankArea(uint16_t address)
+		{
+			return address >= BANK_AREA_START && address < BANK_AREA_START + BANK_AREA_SIZE;
+		}
+
+		void UpdateAddressBit(uint16_t address, uint16_t bank);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -13,20 +13,21 @@ const uint16_t CPU::INTERRUPT_VECTORS[] = { 0x40, 0x48, 0x50, 0x58, 0x60 };
 
 CPU::CPU(Memory& memory) : memory(memory), interruptEnable(memory, GB_REG_IE), interruptFlags(memory, GB_REG_IF)
 {
-	nativePointer = (NativePointer*) malloc(sizeof(NativePointer));
-	memoryPointer = (MemoryPointer*) malloc(sizeof(MemoryPointer));
+	blockCache = new CodeBlock[BLOCK_CACHE_SIZE];
+	FlushBlockCache();
 }
 
 CPU::~CPU()
 {
-	free(nativePointer);
-	free(memoryPointer);
+	delete[] blockCache;
 }
 
 void CPU::Reset()
 {
 	ticks = 0;
 	interruptMasterEnable = true;
+	halted = false;
+	stopped = false;
 
 	registers.af = 0x01B0;
 	registers.bc = 0x0013;
@@ -36,6 +37,10 @@ void CPU::Reset()
 	registers.sp = 0xFFFE;
 	registers.pc = 0x0100;
 
+	flagOperation = FLAG_OP_NONE;
+
+	FlushBlockCache();
+
 	memory.WriteByte(0xFF00, 0x0F); // JOYP
 	memory.WriteByte(0xFF05, 0x00); // TIMA
 	memory.WriteByte(0xFF06, 0x00); // TMA
@@ -76,6 +81,26 @@ void CPU::Resume()
 }
 
 const CPU::Instruction& CPU::ExecuteNextInstruction()
+{
+	const DecodedInstruction* decoded = FetchInstruction();
+
+	if (decoded == NULL)
+		return ExecuteUncachedInstruction();
+
+	// Increase the PC to point to the next instruction
+	registers.pc += decoded->length;
+
+	// Execute the instruction
+	const Instruction& instruction = *decoded->instruction;
+	(this->*instruction.handler)(decoded->opcode, decoded->operands);
+
+	// Increase the clock cycle count
+	ticks += instruction.duration;
+
+	return instruction;
+}
+
+const CPU::Instruction& CPU::ExecuteUncachedInstruction()
 {
 	// Read the opcode the PC points at
 	uint8_t opcode;
@@ -119,8 +144,105 @@ const CPU::Instruction& CPU::ExecuteNextInstruction()
 	return instruction;
 }
 
+const CPU::DecodedInstruction* CPU::FetchInstruction()
+{
+	uint16_t address = registers.pc;
+	const uint8_t* pointer = memory.RetrieveHostPointer(address);
+
+	// Code outside plain memory (IO, HRAM, disabled cartridge RAM) is never cached, neither is code on watched pages
+	if (pointer == NULL)
+		return NULL;
+
+	// Keep executing the current block as long as execution is sequential and its code is still mapped and unmodified
+	if (currentBlock == NULL || blockIdx >= currentBlock->length || 
+		address != blockAddress || pointer != blockPointer || 
+		currentBlock->generation != memory.CodeGeneration(address))
+	{
+		currentBlock = LookupBlock(pointer, address);
+		blockIdx = 0;
+
+		if (currentBlock == NULL)
+			return NULL;
+	}
+
+	const DecodedInstruction* decoded = &currentBlock->instructions[blockIdx++];
+	blockAddress = address + decoded->length;
+	blockPointer = pointer + decoded->length;
+
+	return decoded;
+}
+
+const CPU::CodeBlock* CPU::LookupBlock(const uint8_t* start, uint16_t address)
+{
+	uintptr_t key = (uintptr_t) start;
+	CodeBlock& block = blockCache[(key ^ (key >> 11)) & (BLOCK_CACHE_SIZE - 1)];
+
+	if (block.start != start || block.generation != memory.CodeGeneration(address))
+		DecodeBlock(block, start, address);
+
+	return block.length > 0 ? &block : NULL;
+}
+
+void CPU::DecodeBlock(CodeBlock& block, const uint8_t* start, uint16_t address)
+{
+	block.start = start;
+	block.generation = memory.CodeGeneration(address);
+	block.length = 0;
+
+	// Decoding stops at the end of the page, since the next page might map to somewhere else
+	const uint8_t* code = start;
+	uint16_t remaining = 0x100 - (address & 0xFF);
+
+	while (block.length < MAX_BLOCK_LENGTH && remaining > 0)
+	{
+		bool prefixedInstruction = code[0] == 0xCB;
+
+		if (prefixedInstruction && remaining < 2)
+			break;
+
+		uint8_t opcode = prefixedInstruction ? code[1] : code[0];
+		const Instruction& instruction = prefixedInstruction ? PREFIXED_INSTRUCTION_MAP[opcode] : INSTRUCTION_MAP[opcode];
+
+		uint8_t length = prefixedInstruction ? instruction.length + 1 : instruction.length;
+
+		// Missing instructions are left to the uncached path, which reports them
+		if (instruction.handler == NULL || length > remaining)
+			break;
+
+		DecodedInstruction& decoded = block.instructions[block.length++];
+		decoded.instruction = &instruction;
+		decoded.opcode = opcode;
+		decoded.length = length;
+
+		for (uint8_t operandIdx = 0; operandIdx + 1 < instruction.length; ++operandIdx)
+			decoded.operands[operandIdx] = code[length - instruction.length + 1 + operandIdx];
+
+		code += length;
+		remaining -= length;
+
+		// Code after an unconditional jump or return is usually not reached sequentially
+		if (!prefixedInstruction && (opcode == 0x18 || opcode == 0xC3 || opcode == 0xC9 || opcode == 0xD9 || opcode == 0xE9))
+			break;
+	}
+
+	// Make sure writes to this code are noticed
+	if (block.length > 0)
+		memory.ProtectCode(address);
+}
+
+void CPU::FlushBlockCache()
+{
+	for (uint16_t entryIdx = 0; entryIdx < BLOCK_CACHE_SIZE; ++entryIdx)
+	{
+		blockCache[entryIdx].start = NULL;
+		blockCache[entryIdx].length = 0;
+	}
+
+	currentBlock = NULL;
+	blockIdx = 0;
+}
 
-void CPU::TestInterrupts()
+bool CPU::TestInterrupts()
 {
 	if (interruptMasterEnable)
 	{
@@ -135,10 +257,12 @@ void CPU::TestInterrupts()
 			if (interruptMasterEnable && (interruptState & (1 << interrupt)))
 			{
 				ExecuteInterrupt((Interrupt) interrupt);
-				break;
+				return true;
 			}
 		}
 	}
+
+	return false;
 }
 
 void CPU::RequestInterrupt(Interrupt interrupt)
@@ -164,14 +288,57 @@ void CPU::ExecuteInterrupt(Interrupt interrupt)
 	ticks += GB_ISR_DURATION;
 }
 
-NativePointer* CPU::CreateNativePointer(uint8_t* ptr)
+void CPU::ComputeFlags() const
 {
-	return new (nativePointer) NativePointer(ptr);
-}
+	uint8_t result = flagResult & 0xFF;
+	uint8_t flags = result == 0 ? FLAG_ZERO : 0;
 
-MemoryPointer* CPU::CreateMemoryPointer(uint16_t address)
-{
-	return new (memoryPointer) MemoryPointer(memory, address);
+	switch (flagOperation)
+	{
+		case FLAG_OP_ADD:
+		case FLAG_OP_SUB:
+			// The result is calculated in 16 bits, so a carry or borrow ends up in the upper byte
+			if (flagOperation == FLAG_OP_SUB)
+				flags |= FLAG_SUBTRACT;
+
+			if (CARRY_BIT_4(flagOperandA, flagOperandB, flagResult))
+				flags |= FLAG_HALF_CARRY;
+
+			if (flagResult > 0xFF)
+				flags |= FLAG_CARRY;
+
+			break;
+
+		case FLAG_OP_AND:
+			flags |= FLAG_HALF_CARRY;
+			break;
+
+		case FLAG_OP_OR:
+			break;
+
+		case FLAG_OP_INC:
+			if ((result & 0xF) == 0x0)
+				flags |= FLAG_HALF_CARRY;
+
+			if (flagCarry)
+				flags |= FLAG_CARRY;
+
+			break;
+
+		case FLAG_OP_DEC:
+			flags |= FLAG_SUBTRACT;
+
+			if ((result & 0xF) == 0xF)
+				flags |= FLAG_HALF_CARRY;
+
+			if (flagCarry)
+				flags |= FLAG_CARRY;
+
+			break;
+	}
+
+	registers.f = flags;
+	flagOperation = FLAG_OP_NONE;
 }
 
 uint8_t CPU::ReadStackByte()
@@ -199,42 +366,6 @@ void CPU::WriteStackShort(uint16_t value)
 	memory.WriteShort(registers.sp, value);
 }
 
-uint8_t CPU::ReadSourceValue(uint8_t opcode, const uint8_t* operands) const
-{
-	if (opcode > 0xC0 && (opcode % 8) == 0x6)
-		return operands[0];
-
-	switch (opcode % 8)
-	{
-		case 0x0: return registers.b;
-		case 0x1: return registers.c;
-		case 0x2: return registers.d;
-		case 0x3: return registers.e;
-		case 0x4: return registers.h;
-		case 0x5: return registers.l;
-		case 0x7: return registers.a;
-
-		case 0x6: return memory.ReadByte(registers.hl);
-	}
-
-}
-
-Pointer* CPU::GetSourcePointer(uint8_t opcode)
-{
-	switch (opcode % 8)
-	{
-		case 0x0: return CreateNativePointer(&registers.b);
-		case 0x1: return CreateNativePointer(&registers.c);
-		case 0x2: return CreateNativePointer(&registers.d);
-		case 0x3: return CreateNativePointer(&registers.e);
-		case 0x4: return CreateNativePointer(&registers.h);
-		case 0x5: return CreateNativePointer(&registers.l);
-		case 0x7: return CreateNativePointer(&registers.a);
-
-		case 0x6: return CreateMemoryPointer(registers.hl);
-	}
-}
-
 void CPU::enable_interupts(uint8_t opcode, const uint8_t* operands)
 {
 	interruptMasterEnable = true;
@@ -260,24 +391,6 @@ void CPU::jump(uint8_t opcode, const uint8_t* operands)
 	registers.pc = DECODE_SHORT(operands);
 }
 
-void CPU::jump_conditional(uint8_t opcode, const uint8_t* operands)
-{
-	bool conditional;
-
-	switch (opcode)
-	{
-		case 0xC2: conditional = !GetFlag(FLAG_ZERO); break;
-		case 0xCA: conditional = GetFlag(FLAG_ZERO); break;
-		case 0xD2: conditional = !GetFlag(FLAG_CARRY); break;
-		case 0xDA: conditional = GetFlag(FLAG_CARRY); break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-
-	if (conditional)
-		registers.pc = DECODE_SHORT(operands);
-}
-
 void CPU::jump_to_hl(uint8_t opcode, const uint8_t* operands)
 {
 	registers.pc = registers.hl;
@@ -288,82 +401,17 @@ void CPU::jump_to_offset(uint8_t opcode, const uint8_t* operands)
 	registers.pc += DECODE_SIGNED_BYTE(operands);
 }
 
-void CPU::jump_to_offset_conditional(uint8_t opcode, const uint8_t* operands)
-{
-	bool conditional;
-
-	switch (opcode)
-	{
-		case 0x20: conditional = !GetFlag(FLAG_ZERO); break;
-		case 0x28: conditional = GetFlag(FLAG_ZERO); break;
-		case 0x30: conditional = !GetFlag(FLAG_CARRY); break;
-		case 0x38: conditional = GetFlag(FLAG_CARRY); break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-
-	if (conditional)
-		registers.pc += DECODE_SIGNED_BYTE(operands);
-}
-
 void CPU::call(uint8_t opcode, const uint8_t* operands)
 {
 	WriteStackShort(registers.pc);
 	registers.pc = DECODE_SHORT(operands);
 }
 
-void CPU::call_conditional(uint8_t opcode, const uint8_t* operands)
-{
-	bool conditional;
-
-	switch (opcode)
-	{
-		case 0xC4: conditional = !GetFlag(FLAG_ZERO); break;
-		case 0xCC: conditional = GetFlag(FLAG_ZERO); break;
-		case 0xD4: conditional = !GetFlag(FLAG_CARRY); break;
-		case 0xDC: conditional = GetFlag(FLAG_CARRY); break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-	if (conditional)
-	{
-		WriteStackShort(registers.pc);
-		registers.pc = DECODE_SHORT(operands);
-	}
-}
-
-void CPU::restart(uint8_t opcode, const uint8_t* operands)
-{
-	assert(opcode > 0xC0 && opcode <= 0xFF && (opcode % 16 == 7 || opcode % 16 == 15));
-
-	WriteStackShort(registers.pc);
-	registers.pc = opcode - 0xC7;
-}
-
 void CPU::return_default(uint8_t opcode, const uint8_t* operands)
 {
 	registers.pc = ReadStackShort();
 }
 
-void CPU::return_conditional(uint8_t opcode, const uint8_t* operands)
-{
-	bool conditional;
-
-	switch (opcode)
-	{
-		case 0xC0: conditional = !GetFlag(FLAG_ZERO); break;
-		case 0xC8: conditional = GetFlag(FLAG_ZERO); break;
-		case 0xD0: conditional = !GetFlag(FLAG_CARRY); break;
-		case 0xD8: conditional = GetFlag(FLAG_CARRY); break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-
-	if (conditional)
-		registers.pc = ReadStackShort();
-
-}
-
 void CPU::return_enable_interrupts(uint8_t opcode, const uint8_t* operands)
 {
 	registers.pc = ReadStackShort();
@@ -402,159 +450,6 @@ void CPU::adjust_bcd(uint8_t opcode, const uint8_t* operands)
 	registers.a = value;
 }
 
-void CPU::alu_add(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t value = ReadSourceValue(opcode, operands);
-	uint8_t result = registers.a + value;
-	
-	SetFlag(FLAG_ZERO, result == 0);
-	SetFlag(FLAG_SUBTRACT, false);
-	SetFlag(FLAG_HALF_CARRY, CARRY_BIT_4(registers.a, value, result));
-	SetFlag(FLAG_CARRY, OVERFLOW_8(registers.a, value, result));
-
-	registers.a = result;
-}
-
-void CPU::alu_adc(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t carry = GetFlag(FLAG_CARRY);
-	uint8_t value = ReadSourceValue(opcode, operands);
-	uint8_t result = registers.a + value + carry;
-
-	SetFlag(FLAG_ZERO, result == 0);
-	SetFlag(FLAG_SUBTRACT, false);
-	SetFlag(FLAG_HALF_CARRY, (registers.a & 0xF) + (value & 0xF) + carry > 0xF);
-	SetFlag(FLAG_CARRY, ((uint16_t)registers.a + value + carry) > 0xFF);
-
-	registers.a = result;
-}
-
-void CPU::alu_sub(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t value = ReadSourceValue(opcode, operands);
-	uint8_t result = registers.a - value;
-
-	SetFlag(FLAG_ZERO, result == 0);
-	SetFlag(FLAG_SUBTRACT, true);
-	SetFlag(FLAG_HALF_CARRY, CARRY_BIT_4(registers.a, value, result));
-	SetFlag(FLAG_CARRY, UNDERFLOW_8(registers.a, value, result));
-
-	registers.a = result;
-}
-
-void CPU::alu_sbc(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t carry = GetFlag(FLAG_CARRY);
-	uint8_t value = ReadSourceValue(opcode, operands);
-	uint8_t result = registers.a - value - carry;
-
-	SetFlag(FLAG_ZERO, result == 0);
-	SetFlag(FLAG_SUBTRACT, true);
-	SetFlag(FLAG_HALF_CARRY, (registers.a & 0xF) < ((value & 0xF) + carry));
-	SetFlag(FLAG_CARRY, ((int16_t)registers.a - value - carry) < 0);
-
-	registers.a = result;
-}
-
-void CPU::alu_and(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t value = ReadSourceValue(opcode, operands);
-	registers.a = registers.a & value;
-
-	SetFlag(FLAG_ZERO, registers.a == 0);
-	SetFlag(FLAG_SUBTRACT, false);
-	SetFlag(FLAG_HALF_CARRY, true);
-	SetFlag(FLAG_CARRY, false);
-}
-
-void CPU::alu_or(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t value = ReadSourceValue(opcode, operands);
-	registers.a = registers.a | value;
-
-	SetFlag(FLAG_ZERO, registers.a == 0);
-	SetFlag(FLAG_SUBTRACT, false);
-	SetFlag(FLAG_HALF_CARRY, false);
-	SetFlag(FLAG_CARRY, false);
-}
-
-void CPU::alu_xor(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t value = ReadSourceValue(opcode, operands);
-
-	registers.a = registers.a ^ value;
-
-	SetFlag(FLAG_ZERO, registers.a == 0);
-	SetFlag(FLAG_SUBTRACT, false);
-	SetFlag(FLAG_HALF_CARRY, false);
-	SetFlag(FLAG_CARRY, false);
-}
-
-void CPU::alu_cmp(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t value = ReadSourceValue(opcode, operands);
-	uint8_t result = registers.a - value;
-
-	SetFlag(FLAG_ZERO, result == 0);
-	SetFlag(FLAG_SUBTRACT, true);
-	SetFlag(FLAG_HALF_CARRY, CARRY_BIT_4(registers.a, value, result));
-	SetFlag(FLAG_CARRY, result > registers.a);
-}
-
-void CPU::alu_inc(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* target = NULL;
-
-	switch (opcode)
-	{
-		case 0x04: target = CreateNativePointer(&registers.b); break;
-		case 0x0C: target = CreateNativePointer(&registers.c); break;
-		case 0x14: target = CreateNativePointer(&registers.d); break;
-		case 0x1C: target = CreateNativePointer(&registers.e); break;
-		case 0x24: target = CreateNativePointer(&registers.h); break;
-		case 0x2C: target = CreateNativePointer(&registers.l); break;
-		case 0x3C: target = CreateNativePointer(&registers.a); break;
-
-		case 0x34: target = CreateMemoryPointer(registers.hl); break;
-	}
-
-	uint8_t value = **target;
-	uint8_t result = value + 1;
-
-	SetFlag(FLAG_ZERO, result == 0);
-	SetFlag(FLAG_SUBTRACT, false);
-	SetFlag(FLAG_HALF_CARRY, (result & 0xF) == 0x0);
-
-	*target = result;
-}
-
-void CPU::alu_dec(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* target = NULL;
-
-	switch (opcode)
-	{
-		case 0x05: target = CreateNativePointer(&registers.b); break;
-		case 0x0D: target = CreateNativePointer(&registers.c); break;
-		case 0x15: target = CreateNativePointer(&registers.d); break;
-		case 0x1D: target = CreateNativePointer(&registers.e); break;
-		case 0x25: target = CreateNativePointer(&registers.h); break;
-		case 0x2D: target = CreateNativePointer(&registers.l); break;
-		case 0x3D: target = CreateNativePointer(&registers.a); break;
-
-		case 0x35: target = CreateMemoryPointer(registers.hl); break;
-	}
-
-	uint8_t value = **target;
-	uint8_t result = value - 1;
-
-	SetFlag(FLAG_ZERO, result == 0);
-	SetFlag(FLAG_SUBTRACT, true);
-	SetFlag(FLAG_HALF_CARRY, (result & 0xF) == 0xF);
-
-	*target = result;
-}
-
 void CPU::alu_complement(uint8_t opcode, const uint8_t* operands)
 {
 	registers.a = ~registers.a;
@@ -577,56 +472,6 @@ void CPU::alu_set_carry(uint8_t opcode, const uint8_t* operands)
 	SetFlag(FLAG_CARRY, true);
 }
 
-void CPU::alu_inc_16bit(uint8_t opcode, const uint8_t* operands)
-{
-	switch (opcode >> 4)
-	{
-		case 0x0: ++registers.bc; break;
-		case 0x1: ++registers.de; break;
-		case 0x2: ++registers.hl; break;
-		case 0x3: ++registers.sp; break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-}
-
-void CPU::alu_dec_16bit(uint8_t opcode, const uint8_t* operands)
-{
-	switch (opcode >> 4)
-	{
-		case 0x0: --registers.bc; break;
-		case 0x1: --registers.de; break;
-		case 0x2: --registers.hl; break;
-		case 0x3: --registers.sp; break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-
-}
-
-void CPU::alu_add_hl_16bit(uint8_t opcode, const uint8_t* operands)
-{
-	uint16_t value;
-
-	switch (opcode)
-	{
-		case 0x09: value = registers.bc; break;
-		case 0x19: value = registers.de; break;
-		case 0x29: value = registers.hl; break;
-		case 0x39: value = registers.sp; break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-
-	uint16_t result = registers.hl + value;
-
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = SET_MASK_IF(registers.f, FLAG_HALF_CARRY, CARRY_BIT_12(registers.hl, value, result));
-	registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, OVERFLOW_16(registers.hl, value, result));
-
-	registers.hl = result;
-}
-
 void CPU::alu_add_sp_constant(uint8_t opcode, const uint8_t* operands)
 {
 	int8_t operand = REINTERPRET(operands[0], int8_t);
@@ -640,72 +485,6 @@ void CPU::alu_add_sp_constant(uint8_t opcode, const uint8_t* operands)
 	registers.sp = result;
 }
 
-void CPU::load_constant(uint8_t opcode, const uint8_t* operands)
-{
-	switch (opcode)
-	{
-		case 0x06: registers.b = operands[0]; break;
-		case 0x0E: registers.c = operands[0]; break;
-		case 0x16: registers.d = operands[0]; break;
-		case 0x1E: registers.e = operands[0]; break;
-		case 0x26: registers.h = operands[0]; break;
-		case 0x2E: registers.l = operands[0]; break;
-		case 0x3E: registers.a = operands[0]; break;
-
-		case 0x36: memory.WriteByte(registers.hl, operands[0]); break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-}
-
-
-void CPU::load_memory_to_memory(uint8_t opcode, const uint8_t* operands)
-{
-	uint8_t value = ReadSourceValue(opcode, operands);
-
-	switch (opcode / 8)
-	{
-		case 8: registers.b = value; break;
-		case 9: registers.c = value; break;
-		case 10: registers.d = value; break;
-		case 11: registers.e = value; break;
-		case 12: registers.h = value; break;
-		case 13: registers.l = value; break;
-		case 15: registers.a = value; break;
-
-		case 14: memory.WriteByte(registers.hl, value); break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-}
-
-void CPU::load_accumulator_to_memory(uint8_t opcode, const uint8_t* operands)
-{
-	switch (opcode / 16)
-	{
-		case 0x0: memory.WriteByte(registers.bc, registers.a); break;
-		case 0x1: memory.WriteByte(registers.de, registers.a); break;
-		case 0x2: memory.WriteByte(registers.hl, registers.a); ++registers.hl; break;
-		case 0x3: memory.WriteByte(registers.hl, registers.a); --registers.hl; break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-}
-
-void CPU::load_memory_to_accumulator(uint8_t opcode, const uint8_t* operands)
-{
-	switch (opcode / 16)
-	{
-		case 0x0: memory.Read(registers.bc, registers.a); break;
-		case 0x1: memory.Read(registers.de, registers.a); break;
-		case 0x2: memory.Read(registers.hl, registers.a); ++registers.hl; break;
-		case 0x3: memory.Read(registers.hl, registers.a); --registers.hl; break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-
-}
-
 void CPU::load_accumulator_to_constant_io_register(uint8_t opcode, const uint8_t* operands)
 {
 	memory.WriteByte(GB_IO_REGISTERS + operands[0], registers.a);
@@ -726,19 +505,6 @@ void CPU::load_c_plus_io_register_to_accumulator(uint8_t opcode, const uint8_t*
 	registers.a = memory.ReadByte(GB_IO_REGISTERS + registers.c);
 }
 
-void CPU::load_constant_16bit(uint8_t opcode, const uint8_t* operands)
-{
-	switch (opcode)
-	{
-		case 0x01: registers.bc = DECODE_SHORT(operands); break;
-		case 0x11: registers.de = DECODE_SHORT(operands); break;
-		case 0x21: registers.hl = DECODE_SHORT(operands); break;
-		case 0x31: registers.sp = DECODE_SHORT(operands); break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-}
-
 void CPU::load_hl_to_sp(uint8_t opcode, const uint8_t* operands)
 {
 	registers.sp = registers.hl;
@@ -775,38 +541,10 @@ void CPU::load_memory_to_accumulator_16bit(uint8_t opcode, const uint8_t* operan
 
 }
 
-void CPU::push_stack_16bit(uint8_t opcode, const uint8_t* operands)
-{
-	switch (opcode)
-	{
-		case 0xC5: WriteStackShort(registers.bc); break;
-		case 0xD5: WriteStackShort(registers.de); break;
-		case 0xE5: WriteStackShort(registers.hl); break;
-		case 0xF5: WriteStackShort(registers.af); break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-}
-
-void CPU::pop_stack_16bit(uint8_t opcode, const uint8_t* operands)
-{
-	switch (opcode)
-	{
-		case 0xC1: registers.bc = ReadStackShort(); break;
-		case 0xD1: registers.de = ReadStackShort(); break;
-		case 0xE1: registers.hl = ReadStackShort(); break;
-		
-		case 0xF1: 
-			// POP AF clears the lower nibble of the F register, which seems to be undocumented behaviour
-			registers.af = ReadStackShort() & 0xFFF0; 
-			break;
-
-		default: assert(false && "Invalid opcode for handler!");
-	}
-}
-
 void CPU::rotate_accumulator_left(uint8_t opcode, const uint8_t* operands)
 {
+	MaterializeFlags();
+
 	uint8_t bit7 = READ_BIT(registers.a, 7);
 	registers.a = ((registers.a << 1) | READ_MASK(registers.f, FLAG_CARRY));
 	
@@ -818,6 +556,8 @@ void CPU::rotate_accumulator_left(uint8_t opcode, const uint8_t* operands)
 
 void CPU::rotate_accumulator_right(uint8_t opcode, const uint8_t* operands)
 {
+	MaterializeFlags();
+
 	uint8_t bit0 = READ_BIT(registers.a, 0);
 	registers.a = ((registers.a >> 1) | (READ_MASK(registers.f, FLAG_CARRY) << 7));
 
@@ -829,6 +569,8 @@ void CPU::rotate_accumulator_right(uint8_t opcode, const uint8_t* operands)
 
 void CPU::rotate_accumulator_left_circular(uint8_t opcode, const uint8_t* operands)
 {
+	MaterializeFlags();
+
 	uint8_t bit7 = READ_BIT(registers.a, 7);
 	registers.a = ((registers.a << 1) | bit7);
 
@@ -840,6 +582,8 @@ void CPU::rotate_accumulator_left_circular(uint8_t opcode, const uint8_t* operan
 
 void CPU::rotate_accumulator_right_circular(uint8_t opcode, const uint8_t* operands)
 {
+	MaterializeFlags();
+
 	uint8_t bit0 = READ_BIT(registers.a, 0);
 	registers.a = ((registers.a >> 1) | (bit0 << 7));
 
@@ -847,128 +591,4 @@ void CPU::rotate_accumulator_right_circular(uint8_t opcode, const uint8_t* opera
 	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
 	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
 	registers.f = UNSET_MASK(registers.f, FLAG_ZERO);
-}
-
-void CPU::rotate_left(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-	uint8_t bit7 = READ_BIT(**value, 7);
-	*value = ((**value << 1) | READ_MASK(registers.f, FLAG_CARRY));
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit7);
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, **value == 0);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
-}
-
-void CPU::rotate_right(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-	uint8_t bit0 = READ_BIT(**value, 0);
-	*value = ((**value >> 1) | (READ_MASK(registers.f, FLAG_CARRY) << 7));
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit0);
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, **value == 0);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
-}
-
-void CPU::rotate_left_circular(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-	uint8_t bit7 = READ_BIT(**value, 7);
-	*value = ((**value << 1) | bit7);
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit7);
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, **value == 0);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
-}
-
-void CPU::rotate_right_circular(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-	uint8_t bit0 = READ_BIT(**value, 0);
-	*value = ((**value >> 1) | (bit0 << 7));
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit0);
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, **value == 0);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
-}
-
-void CPU::shift_left_arithmetically(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-	uint8_t bit7 = READ_BIT(**value, 7);
-	*value = **value << 1;
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, **value == 0);
-	registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit7);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
-}
-
-void CPU::shift_right_arithmetically(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-	uint8_t bit7 = READ_BIT(**value, 7);
-	uint8_t bit0 = READ_BIT(**value, 0);
-	*value = SET_BIT_IF(**value >> 1, 7, bit7);
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, **value == 0);
-	registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit0);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
-}
-
-void CPU::shift_right_logically(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-	uint8_t bit0 = READ_BIT(**value, 0);
-	*value = **value >> 1;
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, **value == 0);
-	registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit0);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
-}
-
-void CPU::swap(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-	*value = (**value << 4) | (**value >> 4);
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, **value == 0);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
-	registers.f = UNSET_MASK(registers.f, FLAG_CARRY);
-}
-
-void CPU::test_bit(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-
-	uint8_t bit = (opcode - 0x40) / 8;
-	uint8_t result = READ_BIT(**value, bit);
-
-	registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
-	registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
-	registers.f = SET_MASK(registers.f, FLAG_HALF_CARRY);
-}
-
-void CPU::reset_bit(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-
-	uint8_t bit = (opcode - 0x80) / 8;
-	*value = UNSET_BIT(**value, bit);
-}
-
-void CPU::set_bit(uint8_t opcode, const uint8_t* operands)
-{
-	Pointer* value = GetSourcePointer(opcode);
-
-	uint8_t bit = (opcode - 0xC0) / 8;
-	*value = SET_BIT(**value, bit);
 }
\ No newline at end of file
@@ -10,8 +10,6 @@ namespace libdmg
 {
 	class Memory;
 
-	class Pointer;
-	class NativePointer;
 
 	class CPU
 	{
@@ -60,7 +58,7 @@ namespace libdmg
 		struct Instruction
 		{
 			uint8_t opcode;
-			char* disassemblyFormat;
+			const char* disassemblyFormat;
 			uint8_t length;
 			uint8_t duration;
 			void (CPU::*handler)(uint8_t opcode, const uint8_t* operands);
@@ -78,13 +76,54 @@ namespace libdmg
 		static const Instruction PREFIXED_INSTRUCTION_MAP[256];
 	
 	private:
+		static const uint16_t BLOCK_CACHE_SIZE = 2048;
+		static const uint8_t MAX_BLOCK_LENGTH = 16;
+
+		struct DecodedInstruction
+		{
+			const Instruction* instruction;
+			uint8_t opcode;
+			uint8_t operands[2];
+			uint8_t length;				// Including the prefix byte
+		};
+
+		// Run of instructions decoded from consecutive addresses within a single page.
+		// Blocks are keyed on the host pointer of their first opcode, which distinguishes between banks.
+		struct CodeBlock
+		{
+			const uint8_t* start;
+			uint32_t generation;
+			uint8_t length;
+
+			DecodedInstruction instructions[MAX_BLOCK_LENGTH];
+		};
+
+		// Kind of the last ALU operation whose flags haven't been written to F yet
+		enum FlagOperation
+		{
+			FLAG_OP_NONE,
+			FLAG_OP_ADD,
+			FLAG_OP_SUB,
+			FLAG_OP_AND,
+			FLAG_OP_OR,
+			FLAG_OP_INC,
+			FLAG_OP_DEC
+		};
+
 		static const uint16_t INTERRUPT_VECTORS[];
 		
 		static const uint8_t GB_ISR_DURATION = 5;
 
 		Memory& memory;
 
-		Registers registers;
+		mutable Registers registers;
+
+		// Operands and result of the last ALU operation, F is only updated from these when it is read
+		mutable uint8_t flagOperation;
+		uint8_t flagOperandA;
+		uint8_t flagOperandB;
+		uint16_t flagResult;
+		bool flagCarry;
 
 		uint64_t ticks;
 
@@ -92,12 +131,16 @@ namespace libdmg
 		bool halted;
 		bool stopped;
 
-		NativePointer* nativePointer;
-		MemoryPointer* memoryPointer;
-
 		MemoryPointer interruptEnable;
 		MemoryPointer interruptFlags;
 
+		CodeBlock* blockCache;
+
+		const CodeBlock* currentBlock;
+		uint8_t blockIdx;
+		uint16_t blockAddress;
+		const uint8_t* blockPointer;
+
 	public:
 		CPU(Memory& memory);
 		~CPU();
@@ -106,7 +149,7 @@ namespace libdmg
 		void Resume();
 		
 		const Instruction& ExecuteNextInstruction();
-		void TestInterrupts();
+		bool TestInterrupts();
 
 		void RequestInterrupt(Interrupt interrupt);
 
@@ -114,18 +157,85 @@ namespace libdmg
 		bool Halted() const { return halted; }
 		bool Stopped() const { return stopped; }
 
-		const Registers& GetRegisters() const { return registers; }
+		const Registers& GetRegisters() const
+		{
+			MaterializeFlags();
+			return registers;
+		}
+
+		// Registers without bringing the flags up to date, F is only valid after GetRegisters
+		const Registers& PeekRegisters() const { return registers; }
+
+		uint16_t ProgramCounter() const { return registers.pc; }
+
 		const uint64_t& Ticks() const { return ticks; }
+
+		// Advances the clock for instructions that were skipped by the emulator
+		void SkipTicks(uint64_t skippedTicks) { ticks += skippedTicks; }
 	
 	private:
-		NativePointer* CreateNativePointer(uint8_t* ptr);
-		MemoryPointer* CreateMemoryPointer(uint16_t address);
-
 		void ExecuteInterrupt(Interrupt interrupt);
 
+		const DecodedInstruction* FetchInstruction();
+		const CodeBlock* LookupBlock(const uint8_t* start, uint16_t address);
+		void DecodeBlock(CodeBlock& block, const uint8_t* start, uint16_t address);
+		void FlushBlockCache();
+
+		const Instruction& ExecuteUncachedInstruction();
+
 		// Flag register manipulation
-		DMG_INLINE void SetFlag(Flags flag, bool state) { registers.f = SET_MASK_IF(registers.f, flag, state); }
-		DMG_INLINE bool GetFlag(Flags flag) { return READ_MASK(registers.f, flag); }
+		DMG_INLINE void SetFlag(Flags flag, bool state) 
+		{
+			MaterializeFlags();
+			registers.f = SET_MASK_IF(registers.f, flag, state); 
+		}
+
+		DMG_INLINE bool GetFlag(Flags flag) const
+		{
+			if (flagOperation != FLAG_OP_NONE)
+			{
+				// Conditional instructions only test zero or carry, which can be read from the deferred operation directly
+				if (flag == FLAG_ZERO)
+					return (flagResult & 0xFF) == 0;
+
+				if (flag == FLAG_CARRY)
+				{
+					switch (flagOperation)
+					{
+						case FLAG_OP_ADD:
+						case FLAG_OP_SUB:
+							return flagResult > 0xFF;
+
+						case FLAG_OP_INC:
+						case FLAG_OP_DEC:
+							return flagCarry;
+
+						default:
+							return false;
+					}
+				}
+
+				MaterializeFlags();
+			}
+
+			return READ_MASK(registers.f, flag);
+		}
+
+		DMG_INLINE void DeferFlags(FlagOperation operation, uint8_t a, uint8_t b, uint16_t result)
+		{
+			flagOperation = operation;
+			flagOperandA = a;
+			flagOperandB = b;
+			flagResult = result;
+		}
+
+		DMG_INLINE void MaterializeFlags() const
+		{
+			if (flagOperation != FLAG_OP_NONE)
+				ComputeFlags();
+		}
+
+		void ComputeFlags() const;
 
 		/* Stack utilities*/
 		uint8_t ReadStackByte();
@@ -135,8 +245,11 @@ namespace libdmg
 		void WriteStackShort(uint16_t value);
 
 		/* Memory read/writing */
-		uint8_t ReadSourceValue(uint8_t opcode, const uint8_t* operands) const;
-		Pointer* GetSourcePointer(uint8_t opcode);
+		template <uint8_t opcode> uint8_t ReadSourceValue(const uint8_t* operands) const;
+
+		// Register operands are selected by a 3-bit index in the opcode, index 6 selects the memory at (HL)
+		template <uint8_t index> uint8_t ReadOperand() const;
+		template <uint8_t index> void WriteOperand(uint8_t value);
 		
 		/* ALU utilities */
 
@@ -148,30 +261,30 @@ namespace libdmg
 		void disable_interrupts(uint8_t opcode, const uint8_t* operands);
 
 		void jump(uint8_t opcode, const uint8_t* operands);
-		void jump_conditional(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void jump_conditional(uint8_t, const uint8_t* operands);
 		void jump_to_hl(uint8_t opcode, const uint8_t* operands);
 		void jump_to_offset(uint8_t opcode, const uint8_t* operands);
-		void jump_to_offset_conditional(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void jump_to_offset_conditional(uint8_t, const uint8_t* operands);
 
 		void call(uint8_t opcode, const uint8_t* operands);
-		void call_conditional(uint8_t opcode, const uint8_t* operands);
-		void restart(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void call_conditional(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void restart(uint8_t, const uint8_t* operands);
 
 		void return_default(uint8_t opcode, const uint8_t* operands);
-		void return_conditional(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void return_conditional(uint8_t, const uint8_t* operands);
 		void return_enable_interrupts(uint8_t opcode, const uint8_t* operands);
 
 		/* 8-bit ALU */
-		void alu_add(uint8_t opcode, const uint8_t* operands);
-		void alu_adc(uint8_t opcode, const uint8_t* operands);
-		void alu_sub(uint8_t opcode, const uint8_t* operands);
-		void alu_sbc(uint8_t opcode, const uint8_t* operands);
-		void alu_and(uint8_t opcode, const uint8_t* operands);
-		void alu_or(uint8_t opcode, const uint8_t* operands);
-		void alu_xor(uint8_t opcode, const uint8_t* operands);
-		void alu_cmp(uint8_t opcode, const uint8_t* operands);
-		void alu_inc(uint8_t opcode, const uint8_t* operands);
-		void alu_dec(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void alu_add(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_adc(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_sub(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_sbc(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_and(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_or(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_xor(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_cmp(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_inc(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_dec(uint8_t, const uint8_t* operands);
 		void alu_complement(uint8_t opcode, const uint8_t* operands);
 		void alu_complement_carry(uint8_t opcode, const uint8_t* operands);
 		void alu_set_carry(uint8_t opcode, const uint8_t* operands);
@@ -179,30 +292,30 @@ namespace libdmg
 		void adjust_bcd(uint8_t opcode, const uint8_t* operands);
 
 		/* 16-bit alu */
-		void alu_inc_16bit(uint8_t opcode, const uint8_t* operands);
-		void alu_dec_16bit(uint8_t opcode, const uint8_t* operands);
-		void alu_add_hl_16bit(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void alu_inc_16bit(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_dec_16bit(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void alu_add_hl_16bit(uint8_t, const uint8_t* operands);
 		void alu_add_sp_constant(uint8_t opcode, const uint8_t* operands);
 
 		/* 8-bit loads */
-		void load_constant(uint8_t opcode, const uint8_t* operands);
-		void load_memory_to_memory(uint8_t opcode, const uint8_t* operands);
-		void load_accumulator_to_memory(uint8_t opcode, const uint8_t* operands);
-		void load_memory_to_accumulator(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void load_constant(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void load_memory_to_memory(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void load_accumulator_to_memory(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void load_memory_to_accumulator(uint8_t, const uint8_t* operands);
 		void load_accumulator_to_constant_io_register(uint8_t opcode, const uint8_t* operands);
 		void load_constant_io_register_to_accumulator(uint8_t opcode, const uint8_t* operands);
 		void load_accumulator_to_c_plus_io_register(uint8_t opcode, const uint8_t* operands);
 		void load_c_plus_io_register_to_accumulator(uint8_t opcode, const uint8_t* operands);
 
 		/* 16-bit loads */
-		void load_constant_16bit(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void load_constant_16bit(uint8_t, const uint8_t* operands);
 		void load_hl_to_sp(uint8_t opcode, const uint8_t* operands);
 		void load_sp_plus_constant_to_hl(uint8_t opcode, const uint8_t* operands);
 		void load_sp_to_memory(uint8_t opcode, const uint8_t* operands);
 		void load_accumulator_to_memory_16bit(uint8_t opcode, const uint8_t* operands);
 		void load_memory_to_accumulator_16bit(uint8_t opcode, const uint8_t* operands);
-		void push_stack_16bit(uint8_t opcode, const uint8_t* operands);
-		void pop_stack_16bit(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void push_stack_16bit(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void pop_stack_16bit(uint8_t, const uint8_t* operands);
 
 		/* Rotate & shift */
 		void rotate_accumulator_left(uint8_t opcode, const uint8_t* operands);
@@ -211,18 +324,18 @@ namespace libdmg
 		void rotate_accumulator_right_circular(uint8_t opcode, const uint8_t* operands);
 
 		/* Prefixed instructions */
-		void rotate_left(uint8_t opcode, const uint8_t* operands);
-		void rotate_right(uint8_t opcode, const uint8_t* operands);
-		void rotate_left_circular(uint8_t opcode, const uint8_t* operands);
-		void rotate_right_circular(uint8_t opcode, const uint8_t* operands);
-
-		void shift_left_arithmetically(uint8_t opcode, const uint8_t* operands);
-		void shift_right_arithmetically(uint8_t opcode, const uint8_t* operands);
-		void shift_right_logically(uint8_t opcode, const uint8_t* operands);
-		void swap(uint8_t opcode, const uint8_t* operands);
-		void test_bit(uint8_t opcode, const uint8_t* operands);
-		void reset_bit(uint8_t opcode, const uint8_t* operands);
-		void set_bit(uint8_t opcode, const uint8_t* operands);
+		template <uint8_t opcode> void rotate_left(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void rotate_right(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void rotate_left_circular(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void rotate_right_circular(uint8_t, const uint8_t* operands);
+
+		template <uint8_t opcode> void shift_left_arithmetically(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void shift_right_arithmetically(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void shift_right_logically(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void swap(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void test_bit(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void reset_bit(uint8_t, const uint8_t* operands);
+		template <uint8_t opcode> void set_bit(uint8_t, const uint8_t* operands);
 	};
 }
 
@@ -34,13 +34,13 @@ namespace libdmg
 
 		static bool Halt()
 		{
-			__debugbreak();
+			DMG_DEBUG_BREAK();
 			return true;
 		}
 
 		static void Break()
 		{
-			__debugbreak();
+			DMG_DEBUG_BREAK();
 		}
 	};
 
@@ -0,0 +1,62 @@
+#include "dma.h"
+
+#include "memory.h"
+#include "scheduler.h"
+
+using namespace libdmg;
+
+DMA::DMA(Memory& memory) : memory(memory), ticks(0), transferEndTicks(Scheduler::NEVER), timed(false), dmaRegister(0xFF)
+{
+
+}
+
+void DMA::Reset()
+{
+	ticks = 0;
+	dmaRegister = 0xFF;
+
+	EndTransfer();
+}
+
+void DMA::Sync(const uint64_t& targetTicks)
+{
+	ticks = targetTicks;
+
+	if (ticks >= transferEndTicks)
+		EndTransfer();
+}
+
+uint64_t DMA::NextEvent() const
+{
+	return transferEndTicks;
+}
+
+bool DMA::IsTransferring() const
+{
+	return transferEndTicks != Scheduler::NEVER;
+}
+
+uint8_t DMA::ReadByte(uint16_t) const
+{
+	return dmaRegister;
+}
+
+void DMA::WriteByte(uint16_t, uint8_t value)
+{
+	dmaRegister = value;
+
+	// Nothing can observe the sprite attributes during the transfer, so they can all be copied right away
+	memory.TransferOAM(value);
+
+	if (timed)
+	{
+		transferEndTicks = ticks + TRANSFER_TICKS;
+		memory.LockBus(true);
+	}
+}
+
+void DMA::EndTransfer()
+{
+	transferEndTicks = Scheduler::NEVER;
+	memory.LockBus(false);
+}
\ No newline at end of file
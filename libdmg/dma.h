@@ -0,0 +1,54 @@
+#ifndef _DMA_H_
+#define _DMA_H_
+
+#include "environment.h"
+
+#include "memorybank.h"
+
+namespace libdmg
+{
+	class Memory;
+
+	// OAM DMA controller, mapped to the DMA register.
+	// The sprite attributes are copied at once when a transfer starts. When the transfer is timed, 
+	// the CPU can only access the IO registers and high RAM until the transfer would have finished.
+	class DMA : public MemoryBank
+	{
+	public:
+		static const uint16_t TRANSFER_LENGTH = 0xA0;
+
+		// One byte is transferred every machine cycle
+		static const uint16_t TRANSFER_TICKS = TRANSFER_LENGTH * 4;
+
+	private:
+		Memory& memory;
+
+		uint64_t ticks;
+		uint64_t transferEndTicks;
+
+		bool timed;
+
+		uint8_t dmaRegister;
+
+	public:
+		DMA(Memory& memory);
+
+		void Reset();
+		void Sync(const uint64_t& targetTicks);
+
+		uint64_t NextEvent() const;
+
+		void SetTimed(bool timed) { this->timed = timed; }
+		bool IsTimed() const { return timed; }
+
+		bool IsTransferring() const;
+
+		uint8_t ReadByte(uint16_t address) const;
+		void WriteByte(uint16_t address, uint8_t value);
+
+	private:
+		void EndTransfer();
+	};
+}
+
+#endif
\ No newline at end of file
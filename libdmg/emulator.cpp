@@ -1,5 +1,7 @@
 #include "emulator.h"
 
+#include <string.h>
+
 #include "cpu.h"
 #include "memory.h"
 #include "cartridge.h"
@@ -14,18 +16,33 @@
 using namespace libdmg;
 
 Emulator::Emulator(CPU& cpu, Memory& memory, Cartridge& cartridge, Video& video, Audio& audio, Input& input) : 
-	cpu(cpu), memory(memory), cartridge(cartridge), video(video), audio(audio), input(input),
-	timer(cpu, memory),
-	ticks(0), ticksUntilNextInstruction(0), 
+	cpu(cpu), memory(memory), cartridge(cartridge), video(video), audio(audio), input(input), WatchCallback(NULL),
+	timer(cpu, memory), dma(memory),
+	ticks(0), nextInstructionTicks(0), instructionTicks(0), stopTicks(0),
+	ioAccessed(false), executingInstruction(false), breakpointHit(false), atBreakpoint(false), idleLoopValid(false), instructionsExecuted(0),
 	historyIdx(0), historyLength(0)
 {
-	memory.BindIO(&input, audio.Sound1(), audio.Sound2());
+	for (uint16_t opcode = 0; opcode < 256; ++opcode)
+	{
+		idleLoopInstructions[opcode] = IsIdleLoopInstruction((uint8_t) opcode, false);
+		idleLoopInstructions[256 + opcode] = IsIdleLoopInstruction((uint8_t) opcode, true);
+	}
+
+	memory.BindIO(&input, audio.Sound1(), audio.Sound2(), &dma);
+	memory.BindSynchronizer(this);
+	memory.BindWatchListener(this);
 }
 
 void Emulator::Boot()
 {
 	ticks = 0;
-	ticksUntilNextInstruction = 0;
+	nextInstructionTicks = 0;
+	instructionTicks = 0;
+	stopTicks = 0;
+
+	breakpointHit = false;
+	atBreakpoint = false;
+	idleLoopValid = false;
 
 	// Reset CPU statistics
 	historyIdx = 0;
@@ -34,14 +51,20 @@ void Emulator::Boot()
 	for (uint16_t opcode = 0; opcode < 256; ++opcode)
 		instructionCount[opcode] = 0;
 
+	instructionsExecuted = 0;
+
 	// Map cartridge rom and ram to memory
 	memory.BindCartridge(cartridge);
 
 	// Reset IO subsystems
 	cpu.Reset();
 	timer.Reset();
+	dma.Reset();
 	video.Reset();
 	audio.Reset();
+
+	scheduler.Reset();
+	ScheduleEvents();
 }
 
 void Emulator::Step()
@@ -56,44 +79,268 @@ void Emulator::Step()
 
 void Emulator::Tick()
 {
-	++ticks;
+	Run(ticks + 1);
+}
+
+void Emulator::Run(uint64_t targetTicks)
+{
+	// Resuming from a breakpoint executes the instruction at it, instead of stopping there again
+	bool resuming = atBreakpoint;
+
+	breakpointHit = false;
+	atBreakpoint = false;
 
-	if (!cpu.Stopped())
+	while (ticks < targetTicks && !breakpointHit)
 	{
-		uint64_t previousTicks = cpu.Ticks();
+		// The IO subsystems don't change any state visible to the CPU before their next event, 
+		// so the CPU can run uninterrupted until then
+		uint64_t deadline = std::min(scheduler.NextDeadline(), targetTicks);
 
-		if (!cpu.Halted() && ticksUntilNextInstruction == 0)
+		while (nextInstructionTicks < deadline && !cpu.Halted() && !cpu.Stopped() && !breakpointHit)
 		{
-			// If the CPU is not halted, test interrupts after executing an instruction
-			ExecuteNextInstruction();
-			cpu.TestInterrupts();
+			if (!breakpoints.Empty())
+			{
+				if (!resuming && TestBreakpoint())
+				{
+					breakpointHit = true;
+					atBreakpoint = true;
+					break;
+				}
+
+				resuming = false;
+			}
+
+			uint64_t previousTicks = cpu.Ticks();
+			uint16_t address = cpu.ProgramCounter();
+			instructionTicks = nextInstructionTicks;
+
+			// Test interrupts after executing an instruction
+			executingInstruction = true;
+
+			const CPU::Instruction& instruction = ExecuteNextInstruction();
+			bool interrupted = cpu.TestInterrupts();
+
+			executingInstruction = false;
+
+			// Delay the next CPU instruction until we've caught up
+			nextInstructionTicks = instructionTicks + (cpu.Ticks() - previousTicks) + 1;
+
+			if (cpu.Stopped())
+				stopTicks = instructionTicks + 1;
+
+			// Writes to IO registers can move the deadlines of the subsystems
+			if (ioAccessed)
+			{
+				ScheduleEvents();
+				deadline = std::min(scheduler.NextDeadline(), targetTicks);
+
+				ioAccessed = false;
+			}
+
+			TrackIdleLoop(address, instruction, interrupted, deadline);
+		}
+
+		if (breakpointHit)
+		{
+			// Bring the subsystems up to the start of the next instruction, so the state can be inspected
+			deadline = std::min(deadline, std::max(ticks, nextInstructionTicks));
 		}
+		else if (cpu.Stopped())
+		{
+			// Only a joypad press resumes a stopped CPU, which never happens during a run
+			deadline = targetTicks;
+
+			// The CPU clock is frozen while stopped, which postpones its next instruction
+			uint64_t frozenTicks = std::max(ticks, stopTicks);
+			
+			if (deadline > frozenTicks)
+				nextInstructionTicks += deadline - frozenTicks;
+		}
+		else if (cpu.Halted())
+		{
+			// A halted CPU resumes as soon as an interrupt is requested, 
+			// so all subsystems can be advanced in one go until the next interrupt
+			deadline = std::min(NextInterrupt(), targetTicks);
+
+			nextInstructionTicks = std::max(nextInstructionTicks, deadline);
+		}
+
+		// Update IO subsystems
+		SyncSubsystems(deadline);
+		ScheduleEvents();
+	}
+}
+
+bool Emulator::TestBreakpoint() const
+{
+	uint16_t address = cpu.ProgramCounter();
+	uint16_t romBank = SelectedROMBank();
+
+	if (breakpoints.TestAddress(address, romBank) && breakpoints.Test(address, romBank, cpu))
+		return true;
 
-		if (ticksUntilNextInstruction > 0)
-			--ticksUntilNextInstruction;
+	if (breakpoints.HasOpcodes())
+	{
+		uint8_t opcode = memory.PeekByte(address);
 
-		// Delay next CPU instruction until we've caught up 
-		ticksUntilNextInstruction += (uint32_t)(cpu.Ticks() - previousTicks);
+		if (opcode == 0xCB)
+			return breakpoints.TestOpcode(memory.PeekByte(address + 1), true);
+
+		return breakpoints.TestOpcode(opcode, false);
 	}
 
-	// Update IO subsystems
+	return false;
+}
+
+void Emulator::SyncIO(uint16_t address)
+{
+	// Bring the IO subsystems up to the start of the instruction that accesses them
+	if (instructionTicks > ticks)
+		SyncSubsystems(instructionTicks);
+
+	// DIV and TIMA count up between events, so loops polling them can't be skipped
+	if (address == GB_REG_DIV || address == GB_REG_TIMA)
+		idleLoopValid = false;
+
+	ioAccessed = true;
+}
+
+void Emulator::MemoryWatched(uint16_t address, uint8_t value, WatchKind kind)
+{
+	if (!executingInstruction)
+		return;
+
+	// Interrupt dispatch is attributed to the instruction it follows
+	uint16_t pc = executionHistory[historyIdx];
+
+	if (WatchCallback != NULL)
+		WatchCallback(address, value, pc, kind);
+}
+
+void Emulator::SyncSubsystems(uint64_t targetTicks)
+{
+	ticks = targetTicks;
+
 	timer.Sync(ticks);
+	dma.Sync(ticks);
 	video.Sync(ticks);
 	audio.Sync(ticks);
 }
 
-void Emulator::ExecuteNextInstruction()
+void Emulator::ScheduleEvents()
+{
+	scheduler.Schedule(Scheduler::EVENT_TIMER, timer.NextEvent());
+	scheduler.Schedule(Scheduler::EVENT_VIDEO, video.NextEvent());
+	scheduler.Schedule(Scheduler::EVENT_AUDIO, audio.NextEvent());
+	scheduler.Schedule(Scheduler::EVENT_DMA, dma.NextEvent());
+}
+
+uint64_t Emulator::NextInterrupt() const
+{
+	uint64_t timerInterrupt = timer.NextEvent();
+	uint64_t videoInterrupt = video.NextInterrupt();
+
+	return std::min(timerInterrupt, videoInterrupt);
+}
+
+const CPU::Instruction& Emulator::ExecuteNextInstruction()
 {
 	// Save the PC in the instruction history
-	const CPU::Registers& registers = cpu.GetRegisters();
 	historyIdx = historyIdx < MAX_HISTORY_LENGTH - 1 ? historyIdx + 1 : 0;
 	historyLength = std::min(historyLength + 1U, (unsigned int)MAX_HISTORY_LENGTH);
-	executionHistory[historyIdx] = registers.pc;
+	executionHistory[historyIdx] = cpu.ProgramCounter();
 
 	// Execute the next CPU instruction
 	const CPU::Instruction& instruction = cpu.ExecuteNextInstruction();
 
 	++instructionCount[instruction.opcode];
+	++instructionsExecuted;
+
+	return instruction;
+}
+
+void Emulator::TrackIdleLoop(uint16_t address, const CPU::Instruction& instruction, bool interrupted, uint64_t deadline)
+{
+	bool prefixed = &instruction >= CPU::PREFIXED_INSTRUCTION_MAP && &instruction < CPU::PREFIXED_INSTRUCTION_MAP + 256;
+
+	if (interrupted || !idleLoopInstructions[(prefixed ? 256 : 0) + instruction.opcode])
+		idleLoopValid = false;
+
+	// Only a backwards jump can close a loop
+	if (cpu.ProgramCounter() >= address)
+		return;
+
+	const CPU::Registers& registers = cpu.GetRegisters();
+
+	// A loop that returns to the same state without writing anything will repeat itself exactly, 
+	// until one of the IO registers it reads changes at the next subsystem event.
+	// Skipping it would hide the accesses of the skipped iterations from watches, and breakpoints inside it.
+	if (idleLoopValid && !memory.HasWatches() && memcmp(&registers, &idleLoopRegisters, sizeof(CPU::Registers)) == 0 && !LoopHasBreakpoints(cpu.ProgramCounter(), address))
+	{
+		uint64_t loopTicks = nextInstructionTicks - idleLoopTicks;
+		uint64_t iterations = deadline > nextInstructionTicks ? (deadline - nextInstructionTicks) / loopTicks : 0;
+
+		if (iterations > 0)
+		{
+			nextInstructionTicks += iterations * loopTicks;
+			cpu.SkipTicks(iterations * (cpu.Ticks() - idleLoopCpuTicks));
+			instructionsExecuted += iterations * (instructionsExecuted - idleLoopInstructionsExecuted);
+		}
+	}
+
+	// Start a new iteration at the jump target
+	idleLoopRegisters = registers;
+	idleLoopTicks = nextInstructionTicks;
+	idleLoopCpuTicks = cpu.Ticks();
+	idleLoopInstructionsExecuted = instructionsExecuted;
+	idleLoopValid = true;
+}
+
+bool Emulator::IsIdleLoopInstruction(uint8_t opcode, bool prefixed)
+{
+	// Only instructions that don't write memory or change the interrupt state can be part of an idle loop
+	if (prefixed)
+	{
+		// Bit tests are allowed on (HL), other operations only on registers
+		return (opcode >= 0x40 && opcode < 0x80) || (opcode & 0x07) != 0x06;
+	}
+
+	// LD r, r' and the ALU operations, except for writes to (HL) and HALT
+	if (opcode >= 0x40 && opcode < 0xC0)
+		return opcode < 0x70 || opcode > 0x77;
+
+	switch (opcode)
+	{
+		case 0x00:										// NOP
+		case 0x01: case 0x11: case 0x21: case 0x31:		// LD rr, nn
+		case 0x03: case 0x13: case 0x23: case 0x33:		// INC rr
+		case 0x0B: case 0x1B: case 0x2B: case 0x3B:		// DEC rr
+		case 0x09: case 0x19: case 0x29: case 0x39:		// ADD HL, rr
+		case 0x04: case 0x0C: case 0x14: case 0x1C:		// INC r
+		case 0x24: case 0x2C: case 0x3C:
+		case 0x05: case 0x0D: case 0x15: case 0x1D:		// DEC r
+		case 0x25: case 0x2D: case 0x3D:
+		case 0x06: case 0x0E: case 0x16: case 0x1E:		// LD r, n
+		case 0x26: case 0x2E: case 0x3E:
+		case 0x0A: case 0x1A: case 0x2A: case 0x3A:		// LD A, (rr)
+		case 0x07: case 0x0F: case 0x17: case 0x1F:		// Rotate A
+		case 0x27: case 0x2F: case 0x37: case 0x3F:		// DAA, CPL, SCF, CCF
+		case 0x18: case 0x20: case 0x28: case 0x30:		// JR
+		case 0x38:
+		case 0xC3: case 0xC2: case 0xCA: case 0xD2:		// JP
+		case 0xDA: case 0xE9:
+		case 0xC9: case 0xC0: case 0xC8: case 0xD0:		// RET
+		case 0xD8:
+		case 0xC1: case 0xD1: case 0xE1: case 0xF1:		// POP
+		case 0xC6: case 0xCE: case 0xD6: case 0xDE:		// ALU n
+		case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+		case 0xF0: case 0xF2: case 0xFA:				// LD A, (n)
+		case 0xE8: case 0xF8: case 0xF9:				// Stack pointer arithmetic
+			return true;
+
+		default:
+			return false;
+	}
 }
 
 void Emulator::PrintRegisters() const
@@ -114,8 +361,8 @@ void Emulator::PrintRegisters() const
 		READ_MASK(registers.f, CPU::FLAG_CARRY));
 
 	Debug::Print("pc: 0x%04X; sp: 0x%04X\n", registers.pc, registers.sp);
-	Debug::Print("ime: %d, if: 0x%02X; ie: 0x%02X\n", cpu.InterruptMasterEnable() ? 1 : 0, memory.ReadByte(GB_REG_IF), memory.ReadByte(GB_REG_IE));
-	Debug::Print("DIV: 0x%02X; TIMA: 0x%02X; TMA: 0x%02X; TAC: 0x%02X\n", memory.ReadByte(GB_REG_DIV), memory.ReadByte(GB_REG_TIMA), memory.ReadByte(GB_REG_TMA), memory.ReadByte(GB_REG_TAC));
+	Debug::Print("ime: %d, if: 0x%02X; ie: 0x%02X\n", cpu.InterruptMasterEnable() ? 1 : 0, memory.PeekByte(GB_REG_IF), memory.PeekByte(GB_REG_IE));
+	Debug::Print("DIV: 0x%02X; TIMA: 0x%02X; TMA: 0x%02X; TAC: 0x%02X\n", memory.PeekByte(GB_REG_DIV), memory.PeekByte(GB_REG_TIMA), memory.PeekByte(GB_REG_TMA), memory.PeekByte(GB_REG_TAC));
 	Debug::Print("\n");
 }
 
@@ -152,12 +399,12 @@ const CPU::Instruction& Emulator::PrintInstruction(uint16_t address, bool& prefi
 {
 	static char disassemblyBuffer[256];
 
-	uint8_t opcode = memory.ReadByte(address);
+	uint8_t opcode = memory.PeekByte(address);
 
 	if (opcode == 0xCB)
 	{
 		prefixed = true;
-		opcode = memory.ReadByte(address + 1);
+		opcode = memory.PeekByte(address + 1);
 	}
 	else
 		prefixed = false;
@@ -168,15 +415,15 @@ const CPU::Instruction& Emulator::PrintInstruction(uint16_t address, bool& prefi
 	{
 		case 0:
 		case 1:
-			sprintf_s(disassemblyBuffer, instruction.disassemblyFormat);
+			snprintf(disassemblyBuffer, sizeof(disassemblyBuffer), instruction.disassemblyFormat);
 			break;
 
 		case 2:
-			sprintf_s(disassemblyBuffer, instruction.disassemblyFormat, memory.ReadByte(address + 1));
+			snprintf(disassemblyBuffer, sizeof(disassemblyBuffer), instruction.disassemblyFormat, memory.PeekByte(address + 1));
 			break;
 
 		case 3:
-			sprintf_s(disassemblyBuffer, instruction.disassemblyFormat, memory.ReadShort(address + 1));
+			snprintf(disassemblyBuffer, sizeof(disassemblyBuffer), instruction.disassemblyFormat, memory.PeekByte(address + 1) | (memory.PeekByte(address + 2) << 8));
 			break;
 
 		default:
@@ -220,7 +467,7 @@ void Emulator::PrintInstructionCount() const
 				++suffixIdx;
 			}
 
-			sprintf_s(numberBuffer, 16, "%d%c", count, suffixIdx >= 0 ? suffixes[suffixIdx] : '\0');
+			snprintf(numberBuffer, sizeof(numberBuffer), "%d%c", count, suffixIdx >= 0 ? suffixes[suffixIdx] : '\0');
 
 			Debug::Print("% 6s\t", numberBuffer);
 		}
@@ -4,18 +4,21 @@
 #include "environment.h"
 
 #include "cpu.h"
+#include "memory.h"
 
 #include "timer.h"
+#include "dma.h"
+#include "breakpoints.h"
+#include "scheduler.h"
 
 namespace libdmg
 {
-	class Memory;
 	class Cartridge;
 	class Video;
 	class Audio;
 	class Input;
 
-	class Emulator
+	class Emulator : public IOSynchronizer, public WatchListener
 	{
 	public:
 		CPU& cpu;
@@ -25,19 +28,47 @@ namespace libdmg
 		Audio& audio;
 		Input& input;
 
+		// Called for every access to an address watched through Memory::AddWatch, with the address of the accessing instruction
+		void (*WatchCallback)(uint16_t address, uint8_t value, uint16_t pc, WatchKind kind);
+
 	private:
 		static const uint8_t MAX_HISTORY_LENGTH = 10;
 
 		Timer timer;
+		DMA dma;
+		Breakpoints breakpoints;
+		Scheduler scheduler;
 
 		uint16_t executionHistory[MAX_HISTORY_LENGTH];
 		uint16_t historyIdx;
 		uint16_t historyLength;
 
 		uint32_t instructionCount[256];
+		uint64_t instructionsExecuted;
 
 		uint64_t ticks;
-		uint32_t ticksUntilNextInstruction;
+		uint64_t nextInstructionTicks;
+		uint64_t instructionTicks;
+		uint64_t stopTicks;
+
+		bool ioAccessed;
+
+		// Only accesses made by CPU instructions trigger watches, not those of the subsystems or the host
+		bool executingInstruction;
+
+		// Set when a run stopped early, and when it stopped at a breakpoint. The next run starts by executing the instruction at it.
+		bool breakpointHit;
+		bool atBreakpoint;
+
+		// Idle loop detection, indexed by opcode with prefixed instructions in the upper half
+		bool idleLoopInstructions[512];
+
+		CPU::Registers idleLoopRegisters;
+		uint64_t idleLoopTicks;
+		uint64_t idleLoopCpuTicks;
+		uint64_t idleLoopInstructionsExecuted;
+		bool idleLoopValid;
+
 	public:
 		Emulator(CPU& cpu, Memory& memory, Cartridge& cartridge, Video& video, Audio& audio, Input& input);
 		
@@ -45,15 +76,50 @@ namespace libdmg
 
 		void Tick();
 		void Step();
+		void Run(uint64_t targetTicks);
+
+		void SyncIO(uint16_t address);
+		void MemoryWatched(uint16_t address, uint8_t value, WatchKind kind);
 
 		void PrintRegisters() const;
 		void PrintDisassembly(uint16_t instructionCount) const;
 		void PrintInstructionCount() const;
 
+		// Lets the CPU only access the IO registers and high RAM during OAM DMA transfers, as on hardware
+		void SetDMATimed(bool timed) { dma.SetTimed(timed); }
+
+		// Runs stop before executing an instruction at a breakpoint. Breakpoints can be changed between runs.
+		Breakpoints& GetBreakpoints() { return breakpoints; }
+		bool BreakpointHit() const { return breakpointHit; }
+
+		// Stops the current run after the executing instruction, as if a breakpoint was hit. Can be called from the watch callback.
+		void RequestBreak() { breakpointHit = true; }
+
 		const uint64_t& Ticks() const { return ticks; }
+		const uint64_t& InstructionsExecuted() const { return instructionsExecuted; }
 	
 	private:
-		void ExecuteNextInstruction();
+		const CPU::Instruction& ExecuteNextInstruction();
+		bool TestBreakpoint() const;
+
+		DMG_INLINE bool LoopHasBreakpoints(uint16_t start, uint16_t end) const
+		{
+			return !breakpoints.Empty() && (breakpoints.HasOpcodes() || breakpoints.TestRange(start, end, SelectedROMBank()));
+		}
+
+		// Bank mapped in the switchable ROM area
+		DMG_INLINE uint16_t SelectedROMBank() const
+		{
+			return memory.mbc != NULL ? memory.mbc->SelectedROMBankNumber() : 1;
+		}
+
+		void TrackIdleLoop(uint16_t address, const CPU::Instruction& instruction, bool interrupted, uint64_t deadline);
+
+		void SyncSubsystems(uint64_t targetTicks);
+		void ScheduleEvents();
+		uint64_t NextInterrupt() const;
+
+		static bool IsIdleLoopInstruction(uint8_t opcode, bool prefixed);
 
 		const CPU::Instruction& PrintInstruction(uint16_t address, bool& prefixed) const;
 	};
@@ -11,6 +11,24 @@
 #endif
 
 #define DMG_INLINE inline
-#define DMG_FORCE_INLINE DMG_INLINE __forceinline
+
+#ifdef _MSC_VER
+	#define DMG_FORCE_INLINE DMG_INLINE __forceinline
+	#define DMG_DEBUG_BREAK() __debugbreak()
+#else
+	#define DMG_FORCE_INLINE DMG_INLINE __attribute__((always_inline))
+	#define DMG_DEBUG_BREAK() __builtin_trap()
+#endif
+
+// SSE2 is part of the x64 baseline, AVX2 kernels are only used after runtime detection
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define DMG_SSE2
+
+	#ifdef _MSC_VER
+		#define DMG_TARGET_AVX2
+	#else
+		#define DMG_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
 
 #endif
\ No newline at end of file
@@ -14,6 +14,7 @@
 #define GB_TILE_WIDTH				8
 #define GB_TILE_HEIGHT				8
 #define GB_TILE_SIZE				GB_TILE_WIDTH * GB_TILE_HEIGHT / 4
+#define GB_TILE_COUNT				384
 
 #define GB_MAX_CARTRIDGE_SIZE		8 * 1024 * 1024
 #define GB_MAX_CARTRIDGE_RAM_SIZE	128 * 1024
@@ -22,14 +23,18 @@
 #define GB_VBLANK_DURATION			4560
 #define GB_SEARCH_OAM_DURATION		80
 #define GB_TRANSFER_DATA_DURATION	172
+#define GB_FRAME_DURATION			70224
 
 #define GB_MAX_SCANLINE				153
 
 #define GB_MAX_SPRITES				40
+#define GB_MAX_LINE_SPRITES			10
 
 #define GB_ROM				0x0000
 #define GB_CRAM				0xA000
 #define GB_VRAM				0x8000
+#define GB_WRAM				0xC000
+#define GB_WRAM_ECHO		0xE000
 
 #define GB_BG_MAP_0			0x9800
 #define GB_BG_MAP_1			0x9C00
@@ -43,6 +48,9 @@
 
 #define GB_REG_JOYP			0xFF00			// Joypad
 
+#define GB_REG_SB			0xFF01			// Serial transfer data
+#define GB_REG_SC			0xFF02			// Serial transfer control
+
 #define GB_REG_DIV			0xFF04			// Fixed divider timer
 #define GB_REG_TIMA			0xFF05			// Timer counter
 #define GB_REG_TMA			0xFF06			// Timer modulo
@@ -1,554 +1,555 @@
 #include "cpu.h"
+#include "instructions.h"
 
 using namespace libdmg;
 
 const CPU::Instruction CPU::INSTRUCTION_MAP[] =
 {
 	{ 0x00, "NOP", 1, 4, &CPU::nop },
-	{ 0x01, "LD BC,0x%04X", 3, 12, &CPU::load_constant_16bit },
-	{ 0x02, "LD (BC),A", 1, 8, &CPU::load_accumulator_to_memory },
-	{ 0x03, "INC BC", 1, 8, &CPU::alu_inc_16bit },
-	{ 0x04, "INC B", 1, 4, &CPU::alu_inc },
-	{ 0x05, "DEC B", 1, 4, &CPU::alu_dec },
-	{ 0x06, "LD B,0x%02X", 2, 8, &CPU::load_constant },
+	{ 0x01, "LD BC,0x%04X", 3, 12, &CPU::load_constant_16bit<0x01> },
+	{ 0x02, "LD (BC),A", 1, 8, &CPU::load_accumulator_to_memory<0x02> },
+	{ 0x03, "INC BC", 1, 8, &CPU::alu_inc_16bit<0x03> },
+	{ 0x04, "INC B", 1, 4, &CPU::alu_inc<0x04> },
+	{ 0x05, "DEC B", 1, 4, &CPU::alu_dec<0x05> },
+	{ 0x06, "LD B,0x%02X", 2, 8, &CPU::load_constant<0x06> },
 	{ 0x07, "RLCA", 1, 4, &CPU::rotate_accumulator_left_circular },
 	{ 0x08, "LD (0x%04X),SP", 3, 20, &CPU::load_sp_to_memory },
-	{ 0x09, "ADD HL,BC", 1, 8, &CPU::alu_add_hl_16bit },
-	{ 0x0A, "LD A,(BC)", 1, 8, &CPU::load_memory_to_accumulator },
-	{ 0x0B, "DEC BC", 1, 8, &CPU::alu_dec_16bit },
-	{ 0x0C, "INC C", 1, 4, &CPU::alu_inc },
-	{ 0x0D, "DEC C", 1, 4, &CPU::alu_dec },
-	{ 0x0E, "LD C,0x%02X", 2, 8, &CPU::load_constant },
+	{ 0x09, "ADD HL,BC", 1, 8, &CPU::alu_add_hl_16bit<0x09> },
+	{ 0x0A, "LD A,(BC)", 1, 8, &CPU::load_memory_to_accumulator<0x0A> },
+	{ 0x0B, "DEC BC", 1, 8, &CPU::alu_dec_16bit<0x0B> },
+	{ 0x0C, "INC C", 1, 4, &CPU::alu_inc<0x0C> },
+	{ 0x0D, "DEC C", 1, 4, &CPU::alu_dec<0x0D> },
+	{ 0x0E, "LD C,0x%02X", 2, 8, &CPU::load_constant<0x0E> },
 	{ 0x0F, "RRCA", 1, 4, &CPU::rotate_accumulator_right_circular },
 
 	{ 0x10, "STOP", 2, 4, &CPU::stop },
-	{ 0x11, "LD DE,0x%04X", 3, 12, &CPU::load_constant_16bit },
-	{ 0x12, "LD (DE),A", 1, 8, &CPU::load_accumulator_to_memory },
-	{ 0x13, "INC DE", 1, 8, &CPU::alu_inc_16bit },
-	{ 0x14, "INC D", 1, 4, &CPU::alu_inc },
-	{ 0x15, "DEC D", 1, 4, &CPU::alu_dec },
-	{ 0x16, "LD D,0x%02X", 2, 8, &CPU::load_constant },
+	{ 0x11, "LD DE,0x%04X", 3, 12, &CPU::load_constant_16bit<0x11> },
+	{ 0x12, "LD (DE),A", 1, 8, &CPU::load_accumulator_to_memory<0x12> },
+	{ 0x13, "INC DE", 1, 8, &CPU::alu_inc_16bit<0x13> },
+	{ 0x14, "INC D", 1, 4, &CPU::alu_inc<0x14> },
+	{ 0x15, "DEC D", 1, 4, &CPU::alu_dec<0x15> },
+	{ 0x16, "LD D,0x%02X", 2, 8, &CPU::load_constant<0x16> },
 	{ 0x17, "RLA", 1, 4, &CPU::rotate_accumulator_left },
 	{ 0x18, "JR 0x%02X", 2, 12, &CPU::jump_to_offset },
-	{ 0x19, "ADD HL,DE", 1, 8, &CPU::alu_add_hl_16bit },
-	{ 0x1A, "LD A,(DE)", 1, 8, &CPU::load_memory_to_accumulator },
-	{ 0x1B, "DEC DE", 1, 8, &CPU::alu_dec_16bit },
-	{ 0x1C, "INC E", 1, 4, &CPU::alu_inc },
-	{ 0x1D, "DEC E", 1, 4, &CPU::alu_dec },
-	{ 0x1E, "LD E,0x%02X", 2, 8, &CPU::load_constant },
+	{ 0x19, "ADD HL,DE", 1, 8, &CPU::alu_add_hl_16bit<0x19> },
+	{ 0x1A, "LD A,(DE)", 1, 8, &CPU::load_memory_to_accumulator<0x1A> },
+	{ 0x1B, "DEC DE", 1, 8, &CPU::alu_dec_16bit<0x1B> },
+	{ 0x1C, "INC E", 1, 4, &CPU::alu_inc<0x1C> },
+	{ 0x1D, "DEC E", 1, 4, &CPU::alu_dec<0x1D> },
+	{ 0x1E, "LD E,0x%02X", 2, 8, &CPU::load_constant<0x1E> },
 	{ 0x1F, "RRA", 1, 4, &CPU::rotate_accumulator_right },
 
-	{ 0x20, "JR NZ,0x%02X", 2, 8, &CPU::jump_to_offset_conditional },
-	{ 0x21, "LD HL,0x%04X", 3, 12, &CPU::load_constant_16bit },
-	{ 0x22, "LD (HL+),A", 1, 8, &CPU::load_accumulator_to_memory },
-	{ 0x23, "INC HL", 1, 8, &CPU::alu_inc_16bit },
-	{ 0x24, "INC H", 1, 4, &CPU::alu_inc },
-	{ 0x25, "DEC H", 1, 4, &CPU::alu_dec },
-	{ 0x26, "LD H,0x%02X", 2, 8, &CPU::load_constant },
+	{ 0x20, "JR NZ,0x%02X", 2, 8, &CPU::jump_to_offset_conditional<0x20> },
+	{ 0x21, "LD HL,0x%04X", 3, 12, &CPU::load_constant_16bit<0x21> },
+	{ 0x22, "LD (HL+),A", 1, 8, &CPU::load_accumulator_to_memory<0x22> },
+	{ 0x23, "INC HL", 1, 8, &CPU::alu_inc_16bit<0x23> },
+	{ 0x24, "INC H", 1, 4, &CPU::alu_inc<0x24> },
+	{ 0x25, "DEC H", 1, 4, &CPU::alu_dec<0x25> },
+	{ 0x26, "LD H,0x%02X", 2, 8, &CPU::load_constant<0x26> },
 	{ 0x27, "DAA", 1, 4, &CPU::adjust_bcd },
-	{ 0x28, "JR Z,0x%02X", 2, 8, &CPU::jump_to_offset_conditional },
-	{ 0x29, "ADD HL,HL", 1, 8, &CPU::alu_add_hl_16bit },
-	{ 0x2A, "LD A,(HL+)", 1, 8, &CPU::load_memory_to_accumulator },
-	{ 0x2B, "DEC HL", 1, 8, &CPU::alu_dec_16bit },
-	{ 0x2C, "INC L", 1, 4, &CPU::alu_inc },
-	{ 0x2D, "DEC L", 1, 4, &CPU::alu_dec },
-	{ 0x2E, "LD L,0x%02X", 2, 8, &CPU::load_constant },
+	{ 0x28, "JR Z,0x%02X", 2, 8, &CPU::jump_to_offset_conditional<0x28> },
+	{ 0x29, "ADD HL,HL", 1, 8, &CPU::alu_add_hl_16bit<0x29> },
+	{ 0x2A, "LD A,(HL+)", 1, 8, &CPU::load_memory_to_accumulator<0x2A> },
+	{ 0x2B, "DEC HL", 1, 8, &CPU::alu_dec_16bit<0x2B> },
+	{ 0x2C, "INC L", 1, 4, &CPU::alu_inc<0x2C> },
+	{ 0x2D, "DEC L", 1, 4, &CPU::alu_dec<0x2D> },
+	{ 0x2E, "LD L,0x%02X", 2, 8, &CPU::load_constant<0x2E> },
 	{ 0x2F, "CPL", 1, 4, &CPU::alu_complement },
 
-	{ 0x30, "JR NC,0x%02X", 2, 8, &CPU::jump_to_offset_conditional },
-	{ 0x31, "LD SP,0x%04X", 3, 12, &CPU::load_constant_16bit },
-	{ 0x32, "LD (HL-),A", 1, 8, &CPU::load_accumulator_to_memory },
-	{ 0x33, "INC SP", 1, 8, &CPU::alu_inc_16bit },
-	{ 0x34, "INC (HL)", 1, 12, &CPU::alu_inc },
-	{ 0x35, "DEC (HL)", 1, 12, &CPU::alu_dec },
-	{ 0x36, "LD (HL),0x%02X", 2, 8, &CPU::load_constant },
+	{ 0x30, "JR NC,0x%02X", 2, 8, &CPU::jump_to_offset_conditional<0x30> },
+	{ 0x31, "LD SP,0x%04X", 3, 12, &CPU::load_constant_16bit<0x31> },
+	{ 0x32, "LD (HL-),A", 1, 8, &CPU::load_accumulator_to_memory<0x32> },
+	{ 0x33, "INC SP", 1, 8, &CPU::alu_inc_16bit<0x33> },
+	{ 0x34, "INC (HL)", 1, 12, &CPU::alu_inc<0x34> },
+	{ 0x35, "DEC (HL)", 1, 12, &CPU::alu_dec<0x35> },
+	{ 0x36, "LD (HL),0x%02X", 2, 8, &CPU::load_constant<0x36> },
 	{ 0x37, "SCF", 1, 4, &CPU::alu_set_carry },
-	{ 0x38, "JR C,0x%02X", 2, 8, &CPU::jump_to_offset_conditional },
-	{ 0x39, "ADD HL,SP", 1, 8, &CPU::alu_add_hl_16bit },
-	{ 0x3A, "LD A,(HL-)", 1, 8, &CPU::load_memory_to_accumulator },
-	{ 0x3B, "DEC SP", 1, 8, &CPU::alu_dec_16bit },
-	{ 0x3C, "INC A", 1, 4, &CPU::alu_inc },
-	{ 0x3D, "DEC A", 1, 4, &CPU::alu_dec },
-	{ 0x3E, "LD A,0x%02X", 2, 8, &CPU::load_constant },
+	{ 0x38, "JR C,0x%02X", 2, 8, &CPU::jump_to_offset_conditional<0x38> },
+	{ 0x39, "ADD HL,SP", 1, 8, &CPU::alu_add_hl_16bit<0x39> },
+	{ 0x3A, "LD A,(HL-)", 1, 8, &CPU::load_memory_to_accumulator<0x3A> },
+	{ 0x3B, "DEC SP", 1, 8, &CPU::alu_dec_16bit<0x3B> },
+	{ 0x3C, "INC A", 1, 4, &CPU::alu_inc<0x3C> },
+	{ 0x3D, "DEC A", 1, 4, &CPU::alu_dec<0x3D> },
+	{ 0x3E, "LD A,0x%02X", 2, 8, &CPU::load_constant<0x3E> },
 	{ 0x3F, "CCF", 1, 4, &CPU::alu_complement_carry },
 
-	{ 0x40, "LD B,B", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x41, "LD B,C", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x42, "LD B,D", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x43, "LD B,E", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x44, "LD B,H", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x45, "LD B,L", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x46, "LD B,(HL)", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x47, "LD B,A", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x48, "LD C,B", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x49, "LD C,C", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x4A, "LD C,D", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x4B, "LD C,E", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x4C, "LD C,H", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x4D, "LD C,L", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x4E, "LD C,(HL)", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x4F, "LD C,A", 1, 4, &CPU::load_memory_to_memory },
-
-	{ 0x50, "LD D,B", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x51, "LD D,C", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x52, "LD D,D", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x53, "LD D,E", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x54, "LD D,H", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x55, "LD D,L", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x56, "LD D,(HL)", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x57, "LD D,A", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x58, "LD E,B", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x59, "LD E,C", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x5A, "LD E,D", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x5B, "LD E,E", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x5C, "LD E,H", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x5D, "LD E,L", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x5E, "LD E,(HL)", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x5F, "LD E,A", 1, 4, &CPU::load_memory_to_memory },
-
-	{ 0x60, "LD H,B", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x61, "LD H,C", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x62, "LD H,D", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x63, "LD H,E", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x64, "LD H,H", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x65, "LD H,L", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x66, "LD H,(HL)", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x67, "LD H,A", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x68, "LD L,B", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x69, "LD L,C", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x6A, "LD L,D", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x6B, "LD L,E", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x6C, "LD L,H", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x6D, "LD L,L", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x6E, "LD L,(HL)", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x6F, "LD L,A", 1, 4, &CPU::load_memory_to_memory },
-
-	{ 0x70, "LD (HL),B", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x71, "LD (HL),C", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x72, "LD (HL),D", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x73, "LD (HL),E", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x74, "LD (HL),H", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x75, "LD (HL),L", 1, 8, &CPU::load_memory_to_memory },
+	{ 0x40, "LD B,B", 1, 4, &CPU::load_memory_to_memory<0x40> },
+	{ 0x41, "LD B,C", 1, 4, &CPU::load_memory_to_memory<0x41> },
+	{ 0x42, "LD B,D", 1, 4, &CPU::load_memory_to_memory<0x42> },
+	{ 0x43, "LD B,E", 1, 4, &CPU::load_memory_to_memory<0x43> },
+	{ 0x44, "LD B,H", 1, 4, &CPU::load_memory_to_memory<0x44> },
+	{ 0x45, "LD B,L", 1, 4, &CPU::load_memory_to_memory<0x45> },
+	{ 0x46, "LD B,(HL)", 1, 8, &CPU::load_memory_to_memory<0x46> },
+	{ 0x47, "LD B,A", 1, 4, &CPU::load_memory_to_memory<0x47> },
+	{ 0x48, "LD C,B", 1, 4, &CPU::load_memory_to_memory<0x48> },
+	{ 0x49, "LD C,C", 1, 4, &CPU::load_memory_to_memory<0x49> },
+	{ 0x4A, "LD C,D", 1, 4, &CPU::load_memory_to_memory<0x4A> },
+	{ 0x4B, "LD C,E", 1, 4, &CPU::load_memory_to_memory<0x4B> },
+	{ 0x4C, "LD C,H", 1, 4, &CPU::load_memory_to_memory<0x4C> },
+	{ 0x4D, "LD C,L", 1, 4, &CPU::load_memory_to_memory<0x4D> },
+	{ 0x4E, "LD C,(HL)", 1, 8, &CPU::load_memory_to_memory<0x4E> },
+	{ 0x4F, "LD C,A", 1, 4, &CPU::load_memory_to_memory<0x4F> },
+
+	{ 0x50, "LD D,B", 1, 4, &CPU::load_memory_to_memory<0x50> },
+	{ 0x51, "LD D,C", 1, 4, &CPU::load_memory_to_memory<0x51> },
+	{ 0x52, "LD D,D", 1, 4, &CPU::load_memory_to_memory<0x52> },
+	{ 0x53, "LD D,E", 1, 4, &CPU::load_memory_to_memory<0x53> },
+	{ 0x54, "LD D,H", 1, 4, &CPU::load_memory_to_memory<0x54> },
+	{ 0x55, "LD D,L", 1, 4, &CPU::load_memory_to_memory<0x55> },
+	{ 0x56, "LD D,(HL)", 1, 8, &CPU::load_memory_to_memory<0x56> },
+	{ 0x57, "LD D,A", 1, 4, &CPU::load_memory_to_memory<0x57> },
+	{ 0x58, "LD E,B", 1, 4, &CPU::load_memory_to_memory<0x58> },
+	{ 0x59, "LD E,C", 1, 4, &CPU::load_memory_to_memory<0x59> },
+	{ 0x5A, "LD E,D", 1, 4, &CPU::load_memory_to_memory<0x5A> },
+	{ 0x5B, "LD E,E", 1, 4, &CPU::load_memory_to_memory<0x5B> },
+	{ 0x5C, "LD E,H", 1, 4, &CPU::load_memory_to_memory<0x5C> },
+	{ 0x5D, "LD E,L", 1, 4, &CPU::load_memory_to_memory<0x5D> },
+	{ 0x5E, "LD E,(HL)", 1, 8, &CPU::load_memory_to_memory<0x5E> },
+	{ 0x5F, "LD E,A", 1, 4, &CPU::load_memory_to_memory<0x5F> },
+
+	{ 0x60, "LD H,B", 1, 4, &CPU::load_memory_to_memory<0x60> },
+	{ 0x61, "LD H,C", 1, 4, &CPU::load_memory_to_memory<0x61> },
+	{ 0x62, "LD H,D", 1, 4, &CPU::load_memory_to_memory<0x62> },
+	{ 0x63, "LD H,E", 1, 4, &CPU::load_memory_to_memory<0x63> },
+	{ 0x64, "LD H,H", 1, 4, &CPU::load_memory_to_memory<0x64> },
+	{ 0x65, "LD H,L", 1, 4, &CPU::load_memory_to_memory<0x65> },
+	{ 0x66, "LD H,(HL)", 1, 8, &CPU::load_memory_to_memory<0x66> },
+	{ 0x67, "LD H,A", 1, 4, &CPU::load_memory_to_memory<0x67> },
+	{ 0x68, "LD L,B", 1, 4, &CPU::load_memory_to_memory<0x68> },
+	{ 0x69, "LD L,C", 1, 4, &CPU::load_memory_to_memory<0x69> },
+	{ 0x6A, "LD L,D", 1, 4, &CPU::load_memory_to_memory<0x6A> },
+	{ 0x6B, "LD L,E", 1, 4, &CPU::load_memory_to_memory<0x6B> },
+	{ 0x6C, "LD L,H", 1, 4, &CPU::load_memory_to_memory<0x6C> },
+	{ 0x6D, "LD L,L", 1, 4, &CPU::load_memory_to_memory<0x6D> },
+	{ 0x6E, "LD L,(HL)", 1, 8, &CPU::load_memory_to_memory<0x6E> },
+	{ 0x6F, "LD L,A", 1, 4, &CPU::load_memory_to_memory<0x6F> },
+
+	{ 0x70, "LD (HL),B", 1, 8, &CPU::load_memory_to_memory<0x70> },
+	{ 0x71, "LD (HL),C", 1, 8, &CPU::load_memory_to_memory<0x71> },
+	{ 0x72, "LD (HL),D", 1, 8, &CPU::load_memory_to_memory<0x72> },
+	{ 0x73, "LD (HL),E", 1, 8, &CPU::load_memory_to_memory<0x73> },
+	{ 0x74, "LD (HL),H", 1, 8, &CPU::load_memory_to_memory<0x74> },
+	{ 0x75, "LD (HL),L", 1, 8, &CPU::load_memory_to_memory<0x75> },
 	{ 0x76, "HALT", 1, 4, &CPU::halt },
-	{ 0x77, "LD (HL),A", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x78, "LD A,B", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x79, "LD A,C", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x7A, "LD A,D", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x7B, "LD A,E", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x7C, "LD A,H", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x7D, "LD A,L", 1, 4, &CPU::load_memory_to_memory },
-	{ 0x7E, "LD A,(HL)", 1, 8, &CPU::load_memory_to_memory },
-	{ 0x7F, "LD A,A", 1, 4, &CPU::load_memory_to_memory },
-
-	{ 0x80, "ADD B", 1, 4, &CPU::alu_add },
-	{ 0x81, "ADD C", 1, 4, &CPU::alu_add },
-	{ 0x82, "ADD D", 1, 4, &CPU::alu_add },
-	{ 0x83, "ADD E", 1, 4, &CPU::alu_add },
-	{ 0x84, "ADD H", 1, 4, &CPU::alu_add },
-	{ 0x85, "ADD L", 1, 4, &CPU::alu_add },
-	{ 0x86, "ADD (HL)", 1, 8, &CPU::alu_add },
-	{ 0x87, "ADD A", 1, 4, &CPU::alu_add },
-	{ 0x88, "ADC B", 1, 4, &CPU::alu_adc },
-	{ 0x89, "ADC C", 1, 4, &CPU::alu_adc },
-	{ 0x8A, "ADC D", 1, 4, &CPU::alu_adc },
-	{ 0x8B, "ADC E", 1, 4, &CPU::alu_adc },
-	{ 0x8C, "ADC H", 1, 4, &CPU::alu_adc },
-	{ 0x8D, "ADC L", 1, 4, &CPU::alu_adc },
-	{ 0x8E, "ADC (HL)", 1, 8, &CPU::alu_adc },
-	{ 0x8F, "ADC A", 1, 4, &CPU::alu_adc },
-
-	{ 0x90, "SUB B", 1, 4, &CPU::alu_sub },
-	{ 0x91, "SUB C", 1, 4, &CPU::alu_sub },
-	{ 0x92, "SUB D", 1, 4, &CPU::alu_sub },
-	{ 0x93, "SUB E", 1, 4, &CPU::alu_sub },
-	{ 0x94, "SUB H", 1, 4, &CPU::alu_sub },
-	{ 0x95, "SUB L", 1, 4, &CPU::alu_sub },
-	{ 0x96, "SUB (HL)", 1, 8, &CPU::alu_sub },
-	{ 0x97, "SUB A", 1, 4, &CPU::alu_sub },
-	{ 0x98, "SBC B", 1, 4, &CPU::alu_sbc },
-	{ 0x99, "SBC C", 1, 4, &CPU::alu_sbc },
-	{ 0x9A, "SBC D", 1, 4, &CPU::alu_sbc },
-	{ 0x9B, "SBC E", 1, 4, &CPU::alu_sbc },
-	{ 0x9C, "SBC H", 1, 4, &CPU::alu_sbc },
-	{ 0x9D, "SBC L", 1, 4, &CPU::alu_sbc },
-	{ 0x9E, "SBC (HL)", 1, 8, &CPU::alu_sbc },
-	{ 0x9F, "SBC A", 1, 4, &CPU::alu_sbc },
-
-	{ 0xA0, "AND B", 1, 4, &CPU::alu_and },
-	{ 0xA1, "AND C", 1, 4, &CPU::alu_and },
-	{ 0xA2, "AND D", 1, 4, &CPU::alu_and },
-	{ 0xA3, "AND E", 1, 4, &CPU::alu_and },
-	{ 0xA4, "AND H", 1, 4, &CPU::alu_and },
-	{ 0xA5, "AND L", 1, 4, &CPU::alu_and },
-	{ 0xA6, "AND (HL)", 1, 8, &CPU::alu_and },
-	{ 0xA7, "AND A", 1, 4, &CPU::alu_and },
-	{ 0xA8, "XOR B", 1, 4, &CPU::alu_xor },
-	{ 0xA9, "XOR C", 1, 4, &CPU::alu_xor },
-	{ 0xAA, "XOR D", 1, 4, &CPU::alu_xor },
-	{ 0xAB, "XOR E", 1, 4, &CPU::alu_xor },
-	{ 0xAC, "XOR H", 1, 4, &CPU::alu_xor },
-	{ 0xAD, "XOR L", 1, 4, &CPU::alu_xor },
-	{ 0xAE, "XOR (HL)", 1, 8, &CPU::alu_xor },
-	{ 0xAF, "XOR A", 1, 4, &CPU::alu_xor },
-
-	{ 0xB0, "OR B", 1, 4, &CPU::alu_or },
-	{ 0xB1, "OR C", 1, 4, &CPU::alu_or },
-	{ 0xB2, "OR D", 1, 4, &CPU::alu_or },
-	{ 0xB3, "OR E", 1, 4, &CPU::alu_or },
-	{ 0xB4, "OR H", 1, 4, &CPU::alu_or },
-	{ 0xB5, "OR L", 1, 4, &CPU::alu_or },
-	{ 0xB6, "OR (HL)", 1, 8, &CPU::alu_or },
-	{ 0xB7, "OR A", 1, 4, &CPU::alu_or },
-	{ 0xA8, "CP B", 1, 4, &CPU::alu_cmp },
-	{ 0xA9, "CP C", 1, 4, &CPU::alu_cmp },
-	{ 0xAA, "CP D", 1, 4, &CPU::alu_cmp },
-	{ 0xAB, "CP E", 1, 4, &CPU::alu_cmp },
-	{ 0xAC, "CP H", 1, 4, &CPU::alu_cmp },
-	{ 0xAD, "CP L", 1, 4, &CPU::alu_cmp },
-	{ 0xAE, "CP (HL)", 1, 8, &CPU::alu_cmp },
-	{ 0xAF, "CP A", 1, 4, &CPU::alu_cmp },
-
-	{ 0xC0, "RET NZ", 1, 8, &CPU::return_conditional },
-	{ 0xC1, "POP BC", 1, 12, &CPU::pop_stack_16bit },
-	{ 0xC2, "JP NZ,0x%04X", 3, 12, &CPU::jump_conditional },
+	{ 0x77, "LD (HL),A", 1, 8, &CPU::load_memory_to_memory<0x77> },
+	{ 0x78, "LD A,B", 1, 4, &CPU::load_memory_to_memory<0x78> },
+	{ 0x79, "LD A,C", 1, 4, &CPU::load_memory_to_memory<0x79> },
+	{ 0x7A, "LD A,D", 1, 4, &CPU::load_memory_to_memory<0x7A> },
+	{ 0x7B, "LD A,E", 1, 4, &CPU::load_memory_to_memory<0x7B> },
+	{ 0x7C, "LD A,H", 1, 4, &CPU::load_memory_to_memory<0x7C> },
+	{ 0x7D, "LD A,L", 1, 4, &CPU::load_memory_to_memory<0x7D> },
+	{ 0x7E, "LD A,(HL)", 1, 8, &CPU::load_memory_to_memory<0x7E> },
+	{ 0x7F, "LD A,A", 1, 4, &CPU::load_memory_to_memory<0x7F> },
+
+	{ 0x80, "ADD B", 1, 4, &CPU::alu_add<0x80> },
+	{ 0x81, "ADD C", 1, 4, &CPU::alu_add<0x81> },
+	{ 0x82, "ADD D", 1, 4, &CPU::alu_add<0x82> },
+	{ 0x83, "ADD E", 1, 4, &CPU::alu_add<0x83> },
+	{ 0x84, "ADD H", 1, 4, &CPU::alu_add<0x84> },
+	{ 0x85, "ADD L", 1, 4, &CPU::alu_add<0x85> },
+	{ 0x86, "ADD (HL)", 1, 8, &CPU::alu_add<0x86> },
+	{ 0x87, "ADD A", 1, 4, &CPU::alu_add<0x87> },
+	{ 0x88, "ADC B", 1, 4, &CPU::alu_adc<0x88> },
+	{ 0x89, "ADC C", 1, 4, &CPU::alu_adc<0x89> },
+	{ 0x8A, "ADC D", 1, 4, &CPU::alu_adc<0x8A> },
+	{ 0x8B, "ADC E", 1, 4, &CPU::alu_adc<0x8B> },
+	{ 0x8C, "ADC H", 1, 4, &CPU::alu_adc<0x8C> },
+	{ 0x8D, "ADC L", 1, 4, &CPU::alu_adc<0x8D> },
+	{ 0x8E, "ADC (HL)", 1, 8, &CPU::alu_adc<0x8E> },
+	{ 0x8F, "ADC A", 1, 4, &CPU::alu_adc<0x8F> },
+
+	{ 0x90, "SUB B", 1, 4, &CPU::alu_sub<0x90> },
+	{ 0x91, "SUB C", 1, 4, &CPU::alu_sub<0x91> },
+	{ 0x92, "SUB D", 1, 4, &CPU::alu_sub<0x92> },
+	{ 0x93, "SUB E", 1, 4, &CPU::alu_sub<0x93> },
+	{ 0x94, "SUB H", 1, 4, &CPU::alu_sub<0x94> },
+	{ 0x95, "SUB L", 1, 4, &CPU::alu_sub<0x95> },
+	{ 0x96, "SUB (HL)", 1, 8, &CPU::alu_sub<0x96> },
+	{ 0x97, "SUB A", 1, 4, &CPU::alu_sub<0x97> },
+	{ 0x98, "SBC B", 1, 4, &CPU::alu_sbc<0x98> },
+	{ 0x99, "SBC C", 1, 4, &CPU::alu_sbc<0x99> },
+	{ 0x9A, "SBC D", 1, 4, &CPU::alu_sbc<0x9A> },
+	{ 0x9B, "SBC E", 1, 4, &CPU::alu_sbc<0x9B> },
+	{ 0x9C, "SBC H", 1, 4, &CPU::alu_sbc<0x9C> },
+	{ 0x9D, "SBC L", 1, 4, &CPU::alu_sbc<0x9D> },
+	{ 0x9E, "SBC (HL)", 1, 8, &CPU::alu_sbc<0x9E> },
+	{ 0x9F, "SBC A", 1, 4, &CPU::alu_sbc<0x9F> },
+
+	{ 0xA0, "AND B", 1, 4, &CPU::alu_and<0xA0> },
+	{ 0xA1, "AND C", 1, 4, &CPU::alu_and<0xA1> },
+	{ 0xA2, "AND D", 1, 4, &CPU::alu_and<0xA2> },
+	{ 0xA3, "AND E", 1, 4, &CPU::alu_and<0xA3> },
+	{ 0xA4, "AND H", 1, 4, &CPU::alu_and<0xA4> },
+	{ 0xA5, "AND L", 1, 4, &CPU::alu_and<0xA5> },
+	{ 0xA6, "AND (HL)", 1, 8, &CPU::alu_and<0xA6> },
+	{ 0xA7, "AND A", 1, 4, &CPU::alu_and<0xA7> },
+	{ 0xA8, "XOR B", 1, 4, &CPU::alu_xor<0xA8> },
+	{ 0xA9, "XOR C", 1, 4, &CPU::alu_xor<0xA9> },
+	{ 0xAA, "XOR D", 1, 4, &CPU::alu_xor<0xAA> },
+	{ 0xAB, "XOR E", 1, 4, &CPU::alu_xor<0xAB> },
+	{ 0xAC, "XOR H", 1, 4, &CPU::alu_xor<0xAC> },
+	{ 0xAD, "XOR L", 1, 4, &CPU::alu_xor<0xAD> },
+	{ 0xAE, "XOR (HL)", 1, 8, &CPU::alu_xor<0xAE> },
+	{ 0xAF, "XOR A", 1, 4, &CPU::alu_xor<0xAF> },
+
+	{ 0xB0, "OR B", 1, 4, &CPU::alu_or<0xB0> },
+	{ 0xB1, "OR C", 1, 4, &CPU::alu_or<0xB1> },
+	{ 0xB2, "OR D", 1, 4, &CPU::alu_or<0xB2> },
+	{ 0xB3, "OR E", 1, 4, &CPU::alu_or<0xB3> },
+	{ 0xB4, "OR H", 1, 4, &CPU::alu_or<0xB4> },
+	{ 0xB5, "OR L", 1, 4, &CPU::alu_or<0xB5> },
+	{ 0xB6, "OR (HL)", 1, 8, &CPU::alu_or<0xB6> },
+	{ 0xB7, "OR A", 1, 4, &CPU::alu_or<0xB7> },
+	{ 0xA8, "CP B", 1, 4, &CPU::alu_cmp<0xA8> },
+	{ 0xA9, "CP C", 1, 4, &CPU::alu_cmp<0xA9> },
+	{ 0xAA, "CP D", 1, 4, &CPU::alu_cmp<0xAA> },
+	{ 0xAB, "CP E", 1, 4, &CPU::alu_cmp<0xAB> },
+	{ 0xAC, "CP H", 1, 4, &CPU::alu_cmp<0xAC> },
+	{ 0xAD, "CP L", 1, 4, &CPU::alu_cmp<0xAD> },
+	{ 0xAE, "CP (HL)", 1, 8, &CPU::alu_cmp<0xAE> },
+	{ 0xAF, "CP A", 1, 4, &CPU::alu_cmp<0xAF> },
+
+	{ 0xC0, "RET NZ", 1, 8, &CPU::return_conditional<0xC0> },
+	{ 0xC1, "POP BC", 1, 12, &CPU::pop_stack_16bit<0xC1> },
+	{ 0xC2, "JP NZ,0x%04X", 3, 12, &CPU::jump_conditional<0xC2> },
 	{ 0xC3, "JP 0x%04X", 3, 16, &CPU::jump },
-	{ 0xC4, "CALL NZ,0x%04X", 3, 12, &CPU::call_conditional },
-	{ 0xC5, "PUSH BC", 1, 16, &CPU::push_stack_16bit },
-	{ 0xC6, "ADD A,0x%02X", 2, 8, &CPU::alu_add },
-	{ 0xC7, "RST 00H", 1, 16, &CPU::restart },
-	{ 0xC8, "RET Z", 1, 8, &CPU::return_conditional },
+	{ 0xC4, "CALL NZ,0x%04X", 3, 12, &CPU::call_conditional<0xC4> },
+	{ 0xC5, "PUSH BC", 1, 16, &CPU::push_stack_16bit<0xC5> },
+	{ 0xC6, "ADD A,0x%02X", 2, 8, &CPU::alu_add<0xC6> },
+	{ 0xC7, "RST 00H", 1, 16, &CPU::restart<0xC7> },
+	{ 0xC8, "RET Z", 1, 8, &CPU::return_conditional<0xC8> },
 	{ 0xC9, "RET", 1, 16, &CPU::return_default },
-	{ 0xCA, "JP Z,0x%04X", 3, 12, &CPU::jump_conditional },
+	{ 0xCA, "JP Z,0x%04X", 3, 12, &CPU::jump_conditional<0xCA> },
 	{ 0xCB, "PREFIX CB", 0, 0, NULL },
-	{ 0xCC, "CALL Z,0x%05X", 3, 12, &CPU::call_conditional },
+	{ 0xCC, "CALL Z,0x%05X", 3, 12, &CPU::call_conditional<0xCC> },
 	{ 0xCD, "CALL 0x%04X", 3, 24, &CPU::call },
-	{ 0xCE, "ADC A,0x%02X", 2, 8, &CPU::alu_adc },
-	{ 0xCF, "RST 08H", 1, 16, &CPU::restart },
+	{ 0xCE, "ADC A,0x%02X", 2, 8, &CPU::alu_adc<0xCE> },
+	{ 0xCF, "RST 08H", 1, 16, &CPU::restart<0xCF> },
 
-	{ 0xD0, "RET NC", 1, 8, &CPU::return_conditional },
-	{ 0xD1, "POP DE", 1, 12, &CPU::pop_stack_16bit },
-	{ 0xD2, "JP NC,0x%04X", 3, 12, &CPU::jump_conditional },
+	{ 0xD0, "RET NC", 1, 8, &CPU::return_conditional<0xD0> },
+	{ 0xD1, "POP DE", 1, 12, &CPU::pop_stack_16bit<0xD1> },
+	{ 0xD2, "JP NC,0x%04X", 3, 12, &CPU::jump_conditional<0xD2> },
 	{ 0xD3, "N/I", 0, 0, NULL },
-	{ 0xD4, "CALL NC,0x%04X", 3, 12, &CPU::call_conditional },
-	{ 0xD5, "PUSH DE", 1, 16, &CPU::push_stack_16bit },
-	{ 0xD6, "SUB 0x%02X", 2, 8, &CPU::alu_sub },
-	{ 0xD7, "RST 10H", 1, 16, &CPU::restart },
-	{ 0xD8, "RET C", 1, 8, &CPU::return_conditional },
+	{ 0xD4, "CALL NC,0x%04X", 3, 12, &CPU::call_conditional<0xD4> },
+	{ 0xD5, "PUSH DE", 1, 16, &CPU::push_stack_16bit<0xD5> },
+	{ 0xD6, "SUB 0x%02X", 2, 8, &CPU::alu_sub<0xD6> },
+	{ 0xD7, "RST 10H", 1, 16, &CPU::restart<0xD7> },
+	{ 0xD8, "RET C", 1, 8, &CPU::return_conditional<0xD8> },
 	{ 0xD9, "RETI", 1, 16, &CPU::return_enable_interrupts },
-	{ 0xDA, "JP C,0x%04X", 3, 12, &CPU::jump_conditional },
+	{ 0xDA, "JP C,0x%04X", 3, 12, &CPU::jump_conditional<0xDA> },
 	{ 0xDB, "N/I", 0, 0, NULL },
-	{ 0xDC, "CALL C,0x%04X", 3, 12, &CPU::call_conditional },
+	{ 0xDC, "CALL C,0x%04X", 3, 12, &CPU::call_conditional<0xDC> },
 	{ 0xDD, "N/I", 0, 0, NULL },
-	{ 0xDE, "SBC A,0x%02X", 2, 8, &CPU::alu_sbc },
-	{ 0xDF, "RST 18H", 1, 16, &CPU::restart },
+	{ 0xDE, "SBC A,0x%02X", 2, 8, &CPU::alu_sbc<0xDE> },
+	{ 0xDF, "RST 18H", 1, 16, &CPU::restart<0xDF> },
 
 	{ 0xE0, "LDH (0xFF%02X),A", 2, 12, &CPU::load_accumulator_to_constant_io_register },
-	{ 0xE1, "POP HL", 1, 12, &CPU::pop_stack_16bit },
+	{ 0xE1, "POP HL", 1, 12, &CPU::pop_stack_16bit<0xE1> },
 	{ 0xE2, "LD (0xFF00+C),A", 1, 8, &CPU::load_accumulator_to_c_plus_io_register },
 	{ 0xE3, "N/I", 0, 0, NULL },
 	{ 0xE4, "N/I", 0, 0, NULL },
-	{ 0xE5, "PUSH HL", 1, 16, &CPU::push_stack_16bit },
-	{ 0xE6, "AND 0x%02X", 2, 8, &CPU::alu_and },
-	{ 0xE7, "RST 20H", 1, 16, &CPU::restart },
+	{ 0xE5, "PUSH HL", 1, 16, &CPU::push_stack_16bit<0xE5> },
+	{ 0xE6, "AND 0x%02X", 2, 8, &CPU::alu_and<0xE6> },
+	{ 0xE7, "RST 20H", 1, 16, &CPU::restart<0xE7> },
 	{ 0xE8, "ADD SP,0x%02X", 2, 16, &CPU::alu_add_sp_constant },
 	{ 0xE9, "JP (HL)", 1, 4, &CPU::jump_to_hl },
 	{ 0xEA, "LD (0x%04X),A", 3, 16, &CPU::load_accumulator_to_memory_16bit },
 	{ 0xEB, "N/I", 0, 0, NULL },
 	{ 0xEC, "N/I", 0, 0, NULL },
 	{ 0xED, "N/I", 0, 0, NULL },
-	{ 0xEE, "XOR 0x%02X", 2, 8, &CPU::alu_xor },
-	{ 0xEF, "RST 28H", 1, 16, &CPU::restart },
+	{ 0xEE, "XOR 0x%02X", 2, 8, &CPU::alu_xor<0xEE> },
+	{ 0xEF, "RST 28H", 1, 16, &CPU::restart<0xEF> },
 
 	{ 0xF0, "LDH A,(0xFF%02X)", 2, 12, &CPU::load_constant_io_register_to_accumulator },
-	{ 0xF1, "POP AF", 1, 12, &CPU::pop_stack_16bit },
+	{ 0xF1, "POP AF", 1, 12, &CPU::pop_stack_16bit<0xF1> },
 	{ 0xF2, "LD A,(0xFF00+C)", 1, 8, &CPU::load_c_plus_io_register_to_accumulator },
 	{ 0xF3, "DI", 1, 4, &CPU::disable_interrupts },
 	{ 0xF4, "N/I", 0, 0, NULL },
-	{ 0xF5, "PUSH AF", 1, 16, &CPU::push_stack_16bit },
-	{ 0xF6, "OR 0x%2X", 2, 8, &CPU::alu_or },
-	{ 0xF7, "RST 30H", 1, 16, &CPU::restart },
+	{ 0xF5, "PUSH AF", 1, 16, &CPU::push_stack_16bit<0xF5> },
+	{ 0xF6, "OR 0x%2X", 2, 8, &CPU::alu_or<0xF6> },
+	{ 0xF7, "RST 30H", 1, 16, &CPU::restart<0xF7> },
 	{ 0xF8, "LD HL,SP+0x%02X", 2, 12, &CPU::load_sp_plus_constant_to_hl },
 	{ 0xF9, "LD SP,HL", 1, 8, &CPU::load_hl_to_sp },
 	{ 0xFA, "LD A,(0x%04X)", 3, 16, &CPU::load_memory_to_accumulator_16bit },
 	{ 0xFB, "EI", 1, 4, &CPU::enable_interupts },
 	{ 0xFC, "N/I", 0, 0, NULL },
 	{ 0xFD, "N/I", 0, 0, NULL },
-	{ 0xFE, "CP 0x%02X", 2, 8, &CPU::alu_cmp },
-	{ 0xFF, "RST 38H", 1, 16, &CPU::restart },
+	{ 0xFE, "CP 0x%02X", 2, 8, &CPU::alu_cmp<0xFE> },
+	{ 0xFF, "RST 38H", 1, 16, &CPU::restart<0xFF> },
 };
 
 const CPU::Instruction CPU::PREFIXED_INSTRUCTION_MAP[] =
 {
-	{ 0x00, "RLC B", 1, 8, &CPU::rotate_left_circular },
-	{ 0x01, "RLC C", 1, 8, &CPU::rotate_left_circular },
-	{ 0x02, "RLC D", 1, 8, &CPU::rotate_left_circular },
-	{ 0x03, "RLC E", 1, 8, &CPU::rotate_left_circular },
-	{ 0x04, "RLC H", 1, 8, &CPU::rotate_left_circular },
-	{ 0x05, "RLC L", 1, 8, &CPU::rotate_left_circular },
-	{ 0x06, "RLC (HL)", 1, 16, &CPU::rotate_left_circular },
-	{ 0x07, "RLC A", 1, 8, &CPU::rotate_left_circular },
-	{ 0x08, "RRC B", 1, 8, &CPU::rotate_right_circular },
-	{ 0x09, "RRC C", 1, 8, &CPU::rotate_right_circular },
-	{ 0x0A, "RRC D", 1, 8, &CPU::rotate_right_circular },
-	{ 0x0B, "RRC E", 1, 8, &CPU::rotate_right_circular },
-	{ 0x0C, "RRC H", 1, 8, &CPU::rotate_right_circular },
-	{ 0x0D, "RRC L", 1, 8, &CPU::rotate_right_circular },
-	{ 0x0E, "RRC (HL)", 1, 16, &CPU::rotate_right_circular },
-	{ 0x0F, "RRC A", 1, 8, &CPU::rotate_right_circular },
-
-	{ 0x10, "RL B", 1, 8, &CPU::rotate_left },
-	{ 0x11, "RL C", 1, 8, &CPU::rotate_left },
-	{ 0x12, "RL D", 1, 8, &CPU::rotate_left },
-	{ 0x13, "RL E", 1, 8, &CPU::rotate_left },
-	{ 0x14, "RL H", 1, 8, &CPU::rotate_left },
-	{ 0x15, "RL L", 1, 8, &CPU::rotate_left },
-	{ 0x16, "RL (HL)", 1, 16, &CPU::rotate_left },
-	{ 0x17, "RL A", 1, 8, &CPU::rotate_left },
-	{ 0x18, "RR B", 1, 8, &CPU::rotate_right },
-	{ 0x19, "RR C", 1, 8, &CPU::rotate_right },
-	{ 0x1A, "RR D", 1, 8, &CPU::rotate_right },
-	{ 0x1B, "RR E", 1, 8, &CPU::rotate_right },
-	{ 0x1C, "RR H", 1, 8, &CPU::rotate_right },
-	{ 0x1D, "RR L", 1, 8, &CPU::rotate_right },
-	{ 0x1E, "RR (HL)", 1, 16, &CPU::rotate_right },
-	{ 0x1F, "RR A", 1, 8, &CPU::rotate_right },
-
-	{ 0x20, "SLA B", 1, 8, &CPU::shift_left_arithmetically },
-	{ 0x21, "SLA C", 1, 8, &CPU::shift_left_arithmetically },
-	{ 0x22, "SLA D", 1, 8, &CPU::shift_left_arithmetically },
-	{ 0x23, "SLA E", 1, 8, &CPU::shift_left_arithmetically },
-	{ 0x24, "SLA H", 1, 8, &CPU::shift_left_arithmetically },
-	{ 0x25, "SLA L", 1, 8, &CPU::shift_left_arithmetically },
-	{ 0x26, "SLA (HL)", 1, 16, &CPU::shift_left_arithmetically },
-	{ 0x27, "SLA A", 1, 8, &CPU::shift_left_arithmetically },
-	{ 0x28, "SRA B", 1, 8, &CPU::shift_right_arithmetically },
-	{ 0x29, "SRA C", 1, 8, &CPU::shift_right_arithmetically },
-	{ 0x2A, "SRA D", 1, 8, &CPU::shift_right_arithmetically },
-	{ 0x2B, "SRA E", 1, 8, &CPU::shift_right_arithmetically },
-	{ 0x2C, "SRA H", 1, 8, &CPU::shift_right_arithmetically },
-	{ 0x2D, "SRA L", 1, 8, &CPU::shift_right_arithmetically },
-	{ 0x2E, "SRA (HL)", 1, 16, &CPU::shift_right_arithmetically },
-	{ 0x2F, "SRA A", 1, 8, &CPU::shift_right_arithmetically },
-
-	{ 0x30, "SWAP B", 1, 8, &CPU::swap },
-	{ 0x31, "SWAP C", 1, 8, &CPU::swap },
-	{ 0x32, "SWAP D", 1, 8, &CPU::swap },
-	{ 0x33, "SWAP E", 1, 8, &CPU::swap },
-	{ 0x34, "SWAP H", 1, 8, &CPU::swap },
-	{ 0x35, "SWAP L", 1, 8, &CPU::swap },
-	{ 0x36, "SWAP (HL)", 1, 16, &CPU::swap },
-	{ 0x37, "SWAP A", 1, 8, &CPU::swap },
-	{ 0x38, "SRL B", 1, 8, &CPU::shift_right_logically },
-	{ 0x39, "SRL C", 1, 8, &CPU::shift_right_logically },
-	{ 0x3A, "SRL D", 1, 8, &CPU::shift_right_logically },
-	{ 0x3B, "SRL E", 1, 8, &CPU::shift_right_logically },
-	{ 0x3C, "SRL H", 1, 8, &CPU::shift_right_logically },
-	{ 0x3D, "SRL L", 1, 8, &CPU::shift_right_logically },
-	{ 0x3E, "SRL (HL)", 1, 16, &CPU::shift_right_logically },
-	{ 0x3F, "SRL A", 1, 8, &CPU::shift_right_logically },
-
-	{ 0x40, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x41, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x42, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x43, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x44, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x45, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x46, "BIT", 1, 16, &CPU::test_bit },
-	{ 0x47, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x48, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x49, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x4A, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x4B, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x4C, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x4D, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x4E, "BIT", 1, 16, &CPU::test_bit },
-	{ 0x4F, "BIT", 1, 8, &CPU::test_bit },
-
-	{ 0x50, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x51, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x52, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x53, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x54, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x55, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x56, "BIT", 1, 16, &CPU::test_bit },
-	{ 0x57, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x58, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x59, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x5A, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x5B, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x5C, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x5D, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x5E, "BIT", 1, 16, &CPU::test_bit },
-	{ 0x5F, "BIT", 1, 8, &CPU::test_bit },
-
-	{ 0x60, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x61, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x62, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x63, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x64, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x65, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x66, "BIT", 1, 16, &CPU::test_bit },
-	{ 0x67, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x68, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x69, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x6A, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x6B, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x6C, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x6D, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x6E, "BIT", 1, 16, &CPU::test_bit },
-	{ 0x6F, "BIT", 1, 8, &CPU::test_bit },
-
-	{ 0x70, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x71, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x72, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x73, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x74, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x75, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x76, "BIT", 1, 16, &CPU::test_bit },
-	{ 0x77, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x78, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x79, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x7A, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x7B, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x7C, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x7D, "BIT", 1, 8, &CPU::test_bit },
-	{ 0x7E, "BIT", 1, 16, &CPU::test_bit },
-	{ 0x7F, "BIT", 1, 8, &CPU::test_bit },
-
-	{ 0x80, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x81, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x82, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x83, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x84, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x85, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x86, "RES", 1, 16, &CPU::reset_bit },
-	{ 0x87, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x88, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x89, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x8A, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x8B, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x8C, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x8D, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x8E, "RES", 1, 16, &CPU::reset_bit },
-	{ 0x8F, "RES", 1, 8, &CPU::reset_bit },
-
-	{ 0x90, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x91, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x92, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x93, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x94, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x95, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x96, "RES", 1, 16, &CPU::reset_bit },
-	{ 0x97, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x98, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x99, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x9A, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x9B, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x9C, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x9D, "RES", 1, 8, &CPU::reset_bit },
-	{ 0x9E, "RES", 1, 16, &CPU::reset_bit },
-	{ 0x9F, "RES", 1, 8, &CPU::reset_bit },
-
-	{ 0xA0, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xA1, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xA2, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xA3, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xA4, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xA5, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xA6, "RES", 1, 16, &CPU::reset_bit },
-	{ 0xA7, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xA8, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xA9, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xAA, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xAB, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xAC, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xAD, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xAE, "RES", 1, 16, &CPU::reset_bit },
-	{ 0xAF, "RES", 1, 8, &CPU::reset_bit },
-
-	{ 0xB0, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xB1, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xB2, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xB3, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xB4, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xB5, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xB6, "RES", 1, 16, &CPU::reset_bit },
-	{ 0xB7, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xB8, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xB9, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xBA, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xBB, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xBC, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xBD, "RES", 1, 8, &CPU::reset_bit },
-	{ 0xBE, "RES", 1, 16, &CPU::reset_bit },
-	{ 0xBF, "RES", 1, 8, &CPU::reset_bit },
-
-	{ 0xC0, "SET", 1, 8, &CPU::set_bit },
-	{ 0xC1, "SET", 1, 8, &CPU::set_bit },
-	{ 0xC2, "SET", 1, 8, &CPU::set_bit },
-	{ 0xC3, "SET", 1, 8, &CPU::set_bit },
-	{ 0xC4, "SET", 1, 8, &CPU::set_bit },
-	{ 0xC5, "SET", 1, 8, &CPU::set_bit },
-	{ 0xC6, "SET", 1, 16, &CPU::set_bit },
-	{ 0xC7, "SET", 1, 8, &CPU::set_bit },
-	{ 0xC8, "SET", 1, 8, &CPU::set_bit },
-	{ 0xC9, "SET", 1, 8, &CPU::set_bit },
-	{ 0xCA, "SET", 1, 8, &CPU::set_bit },
-	{ 0xCB, "SET", 1, 8, &CPU::set_bit },
-	{ 0xCC, "SET", 1, 8, &CPU::set_bit },
-	{ 0xCD, "SET", 1, 8, &CPU::set_bit },
-	{ 0xCE, "SET", 1, 16, &CPU::set_bit },
-	{ 0xCF, "SET", 1, 8, &CPU::set_bit },
-
-	{ 0xD0, "SET", 1, 8, &CPU::set_bit },
-	{ 0xD1, "SET", 1, 8, &CPU::set_bit },
-	{ 0xD2, "SET", 1, 8, &CPU::set_bit },
-	{ 0xD3, "SET", 1, 8, &CPU::set_bit },
-	{ 0xD4, "SET", 1, 8, &CPU::set_bit },
-	{ 0xD5, "SET", 1, 8, &CPU::set_bit },
-	{ 0xD6, "SET", 1, 16, &CPU::set_bit },
-	{ 0xD7, "SET", 1, 8, &CPU::set_bit },
-	{ 0xD8, "SET", 1, 8, &CPU::set_bit },
-	{ 0xD9, "SET", 1, 8, &CPU::set_bit },
-	{ 0xDA, "SET", 1, 8, &CPU::set_bit },
-	{ 0xDB, "SET", 1, 8, &CPU::set_bit },
-	{ 0xDC, "SET", 1, 8, &CPU::set_bit },
-	{ 0xDD, "SET", 1, 8, &CPU::set_bit },
-	{ 0xDE, "SET", 1, 16, &CPU::set_bit },
-	{ 0xDF, "SET", 1, 8, &CPU::set_bit },
-
-	{ 0xE0, "SET", 1, 8, &CPU::set_bit },
-	{ 0xE1, "SET", 1, 8, &CPU::set_bit },
-	{ 0xE2, "SET", 1, 8, &CPU::set_bit },
-	{ 0xE3, "SET", 1, 8, &CPU::set_bit },
-	{ 0xE4, "SET", 1, 8, &CPU::set_bit },
-	{ 0xE5, "SET", 1, 8, &CPU::set_bit },
-	{ 0xE6, "SET", 1, 16, &CPU::set_bit },
-	{ 0xE7, "SET", 1, 8, &CPU::set_bit },
-	{ 0xE8, "SET", 1, 8, &CPU::set_bit },
-	{ 0xE9, "SET", 1, 8, &CPU::set_bit },
-	{ 0xEA, "SET", 1, 8, &CPU::set_bit },
-	{ 0xEB, "SET", 1, 8, &CPU::set_bit },
-	{ 0xEC, "SET", 1, 8, &CPU::set_bit },
-	{ 0xED, "SET", 1, 8, &CPU::set_bit },
-	{ 0xEE, "SET", 1, 16, &CPU::set_bit },
-	{ 0xEF, "SET", 1, 8, &CPU::set_bit },
-
-	{ 0xF0, "SET", 1, 8, &CPU::set_bit },
-	{ 0xF1, "SET", 1, 8, &CPU::set_bit },
-	{ 0xF2, "SET", 1, 8, &CPU::set_bit },
-	{ 0xF3, "SET", 1, 8, &CPU::set_bit },
-	{ 0xF4, "SET", 1, 8, &CPU::set_bit },
-	{ 0xF5, "SET", 1, 8, &CPU::set_bit },
-	{ 0xF6, "SET", 1, 16, &CPU::set_bit },
-	{ 0xF7, "SET", 1, 8, &CPU::set_bit },
-	{ 0xF8, "SET", 1, 8, &CPU::set_bit },
-	{ 0xF9, "SET", 1, 8, &CPU::set_bit },
-	{ 0xFA, "SET", 1, 8, &CPU::set_bit },
-	{ 0xFB, "SET", 1, 8, &CPU::set_bit },
-	{ 0xFC, "SET", 1, 8, &CPU::set_bit },
-	{ 0xFD, "SET", 1, 8, &CPU::set_bit },
-	{ 0xFE, "SET", 1, 16, &CPU::set_bit },
-	{ 0xFF, "SET", 1, 8, &CPU::set_bit },
+	{ 0x00, "RLC B", 1, 8, &CPU::rotate_left_circular<0x00> },
+	{ 0x01, "RLC C", 1, 8, &CPU::rotate_left_circular<0x01> },
+	{ 0x02, "RLC D", 1, 8, &CPU::rotate_left_circular<0x02> },
+	{ 0x03, "RLC E", 1, 8, &CPU::rotate_left_circular<0x03> },
+	{ 0x04, "RLC H", 1, 8, &CPU::rotate_left_circular<0x04> },
+	{ 0x05, "RLC L", 1, 8, &CPU::rotate_left_circular<0x05> },
+	{ 0x06, "RLC (HL)", 1, 16, &CPU::rotate_left_circular<0x06> },
+	{ 0x07, "RLC A", 1, 8, &CPU::rotate_left_circular<0x07> },
+	{ 0x08, "RRC B", 1, 8, &CPU::rotate_right_circular<0x08> },
+	{ 0x09, "RRC C", 1, 8, &CPU::rotate_right_circular<0x09> },
+	{ 0x0A, "RRC D", 1, 8, &CPU::rotate_right_circular<0x0A> },
+	{ 0x0B, "RRC E", 1, 8, &CPU::rotate_right_circular<0x0B> },
+	{ 0x0C, "RRC H", 1, 8, &CPU::rotate_right_circular<0x0C> },
+	{ 0x0D, "RRC L", 1, 8, &CPU::rotate_right_circular<0x0D> },
+	{ 0x0E, "RRC (HL)", 1, 16, &CPU::rotate_right_circular<0x0E> },
+	{ 0x0F, "RRC A", 1, 8, &CPU::rotate_right_circular<0x0F> },
+
+	{ 0x10, "RL B", 1, 8, &CPU::rotate_left<0x10> },
+	{ 0x11, "RL C", 1, 8, &CPU::rotate_left<0x11> },
+	{ 0x12, "RL D", 1, 8, &CPU::rotate_left<0x12> },
+	{ 0x13, "RL E", 1, 8, &CPU::rotate_left<0x13> },
+	{ 0x14, "RL H", 1, 8, &CPU::rotate_left<0x14> },
+	{ 0x15, "RL L", 1, 8, &CPU::rotate_left<0x15> },
+	{ 0x16, "RL (HL)", 1, 16, &CPU::rotate_left<0x16> },
+	{ 0x17, "RL A", 1, 8, &CPU::rotate_left<0x17> },
+	{ 0x18, "RR B", 1, 8, &CPU::rotate_right<0x18> },
+	{ 0x19, "RR C", 1, 8, &CPU::rotate_right<0x19> },
+	{ 0x1A, "RR D", 1, 8, &CPU::rotate_right<0x1A> },
+	{ 0x1B, "RR E", 1, 8, &CPU::rotate_right<0x1B> },
+	{ 0x1C, "RR H", 1, 8, &CPU::rotate_right<0x1C> },
+	{ 0x1D, "RR L", 1, 8, &CPU::rotate_right<0x1D> },
+	{ 0x1E, "RR (HL)", 1, 16, &CPU::rotate_right<0x1E> },
+	{ 0x1F, "RR A", 1, 8, &CPU::rotate_right<0x1F> },
+
+	{ 0x20, "SLA B", 1, 8, &CPU::shift_left_arithmetically<0x20> },
+	{ 0x21, "SLA C", 1, 8, &CPU::shift_left_arithmetically<0x21> },
+	{ 0x22, "SLA D", 1, 8, &CPU::shift_left_arithmetically<0x22> },
+	{ 0x23, "SLA E", 1, 8, &CPU::shift_left_arithmetically<0x23> },
+	{ 0x24, "SLA H", 1, 8, &CPU::shift_left_arithmetically<0x24> },
+	{ 0x25, "SLA L", 1, 8, &CPU::shift_left_arithmetically<0x25> },
+	{ 0x26, "SLA (HL)", 1, 16, &CPU::shift_left_arithmetically<0x26> },
+	{ 0x27, "SLA A", 1, 8, &CPU::shift_left_arithmetically<0x27> },
+	{ 0x28, "SRA B", 1, 8, &CPU::shift_right_arithmetically<0x28> },
+	{ 0x29, "SRA C", 1, 8, &CPU::shift_right_arithmetically<0x29> },
+	{ 0x2A, "SRA D", 1, 8, &CPU::shift_right_arithmetically<0x2A> },
+	{ 0x2B, "SRA E", 1, 8, &CPU::shift_right_arithmetically<0x2B> },
+	{ 0x2C, "SRA H", 1, 8, &CPU::shift_right_arithmetically<0x2C> },
+	{ 0x2D, "SRA L", 1, 8, &CPU::shift_right_arithmetically<0x2D> },
+	{ 0x2E, "SRA (HL)", 1, 16, &CPU::shift_right_arithmetically<0x2E> },
+	{ 0x2F, "SRA A", 1, 8, &CPU::shift_right_arithmetically<0x2F> },
+
+	{ 0x30, "SWAP B", 1, 8, &CPU::swap<0x30> },
+	{ 0x31, "SWAP C", 1, 8, &CPU::swap<0x31> },
+	{ 0x32, "SWAP D", 1, 8, &CPU::swap<0x32> },
+	{ 0x33, "SWAP E", 1, 8, &CPU::swap<0x33> },
+	{ 0x34, "SWAP H", 1, 8, &CPU::swap<0x34> },
+	{ 0x35, "SWAP L", 1, 8, &CPU::swap<0x35> },
+	{ 0x36, "SWAP (HL)", 1, 16, &CPU::swap<0x36> },
+	{ 0x37, "SWAP A", 1, 8, &CPU::swap<0x37> },
+	{ 0x38, "SRL B", 1, 8, &CPU::shift_right_logically<0x38> },
+	{ 0x39, "SRL C", 1, 8, &CPU::shift_right_logically<0x39> },
+	{ 0x3A, "SRL D", 1, 8, &CPU::shift_right_logically<0x3A> },
+	{ 0x3B, "SRL E", 1, 8, &CPU::shift_right_logically<0x3B> },
+	{ 0x3C, "SRL H", 1, 8, &CPU::shift_right_logically<0x3C> },
+	{ 0x3D, "SRL L", 1, 8, &CPU::shift_right_logically<0x3D> },
+	{ 0x3E, "SRL (HL)", 1, 16, &CPU::shift_right_logically<0x3E> },
+	{ 0x3F, "SRL A", 1, 8, &CPU::shift_right_logically<0x3F> },
+
+	{ 0x40, "BIT", 1, 8, &CPU::test_bit<0x40> },
+	{ 0x41, "BIT", 1, 8, &CPU::test_bit<0x41> },
+	{ 0x42, "BIT", 1, 8, &CPU::test_bit<0x42> },
+	{ 0x43, "BIT", 1, 8, &CPU::test_bit<0x43> },
+	{ 0x44, "BIT", 1, 8, &CPU::test_bit<0x44> },
+	{ 0x45, "BIT", 1, 8, &CPU::test_bit<0x45> },
+	{ 0x46, "BIT", 1, 16, &CPU::test_bit<0x46> },
+	{ 0x47, "BIT", 1, 8, &CPU::test_bit<0x47> },
+	{ 0x48, "BIT", 1, 8, &CPU::test_bit<0x48> },
+	{ 0x49, "BIT", 1, 8, &CPU::test_bit<0x49> },
+	{ 0x4A, "BIT", 1, 8, &CPU::test_bit<0x4A> },
+	{ 0x4B, "BIT", 1, 8, &CPU::test_bit<0x4B> },
+	{ 0x4C, "BIT", 1, 8, &CPU::test_bit<0x4C> },
+	{ 0x4D, "BIT", 1, 8, &CPU::test_bit<0x4D> },
+	{ 0x4E, "BIT", 1, 16, &CPU::test_bit<0x4E> },
+	{ 0x4F, "BIT", 1, 8, &CPU::test_bit<0x4F> },
+
+	{ 0x50, "BIT", 1, 8, &CPU::test_bit<0x50> },
+	{ 0x51, "BIT", 1, 8, &CPU::test_bit<0x51> },
+	{ 0x52, "BIT", 1, 8, &CPU::test_bit<0x52> },
+	{ 0x53, "BIT", 1, 8, &CPU::test_bit<0x53> },
+	{ 0x54, "BIT", 1, 8, &CPU::test_bit<0x54> },
+	{ 0x55, "BIT", 1, 8, &CPU::test_bit<0x55> },
+	{ 0x56, "BIT", 1, 16, &CPU::test_bit<0x56> },
+	{ 0x57, "BIT", 1, 8, &CPU::test_bit<0x57> },
+	{ 0x58, "BIT", 1, 8, &CPU::test_bit<0x58> },
+	{ 0x59, "BIT", 1, 8, &CPU::test_bit<0x59> },
+	{ 0x5A, "BIT", 1, 8, &CPU::test_bit<0x5A> },
+	{ 0x5B, "BIT", 1, 8, &CPU::test_bit<0x5B> },
+	{ 0x5C, "BIT", 1, 8, &CPU::test_bit<0x5C> },
+	{ 0x5D, "BIT", 1, 8, &CPU::test_bit<0x5D> },
+	{ 0x5E, "BIT", 1, 16, &CPU::test_bit<0x5E> },
+	{ 0x5F, "BIT", 1, 8, &CPU::test_bit<0x5F> },
+
+	{ 0x60, "BIT", 1, 8, &CPU::test_bit<0x60> },
+	{ 0x61, "BIT", 1, 8, &CPU::test_bit<0x61> },
+	{ 0x62, "BIT", 1, 8, &CPU::test_bit<0x62> },
+	{ 0x63, "BIT", 1, 8, &CPU::test_bit<0x63> },
+	{ 0x64, "BIT", 1, 8, &CPU::test_bit<0x64> },
+	{ 0x65, "BIT", 1, 8, &CPU::test_bit<0x65> },
+	{ 0x66, "BIT", 1, 16, &CPU::test_bit<0x66> },
+	{ 0x67, "BIT", 1, 8, &CPU::test_bit<0x67> },
+	{ 0x68, "BIT", 1, 8, &CPU::test_bit<0x68> },
+	{ 0x69, "BIT", 1, 8, &CPU::test_bit<0x69> },
+	{ 0x6A, "BIT", 1, 8, &CPU::test_bit<0x6A> },
+	{ 0x6B, "BIT", 1, 8, &CPU::test_bit<0x6B> },
+	{ 0x6C, "BIT", 1, 8, &CPU::test_bit<0x6C> },
+	{ 0x6D, "BIT", 1, 8, &CPU::test_bit<0x6D> },
+	{ 0x6E, "BIT", 1, 16, &CPU::test_bit<0x6E> },
+	{ 0x6F, "BIT", 1, 8, &CPU::test_bit<0x6F> },
+
+	{ 0x70, "BIT", 1, 8, &CPU::test_bit<0x70> },
+	{ 0x71, "BIT", 1, 8, &CPU::test_bit<0x71> },
+	{ 0x72, "BIT", 1, 8, &CPU::test_bit<0x72> },
+	{ 0x73, "BIT", 1, 8, &CPU::test_bit<0x73> },
+	{ 0x74, "BIT", 1, 8, &CPU::test_bit<0x74> },
+	{ 0x75, "BIT", 1, 8, &CPU::test_bit<0x75> },
+	{ 0x76, "BIT", 1, 16, &CPU::test_bit<0x76> },
+	{ 0x77, "BIT", 1, 8, &CPU::test_bit<0x77> },
+	{ 0x78, "BIT", 1, 8, &CPU::test_bit<0x78> },
+	{ 0x79, "BIT", 1, 8, &CPU::test_bit<0x79> },
+	{ 0x7A, "BIT", 1, 8, &CPU::test_bit<0x7A> },
+	{ 0x7B, "BIT", 1, 8, &CPU::test_bit<0x7B> },
+	{ 0x7C, "BIT", 1, 8, &CPU::test_bit<0x7C> },
+	{ 0x7D, "BIT", 1, 8, &CPU::test_bit<0x7D> },
+	{ 0x7E, "BIT", 1, 16, &CPU::test_bit<0x7E> },
+	{ 0x7F, "BIT", 1, 8, &CPU::test_bit<0x7F> },
+
+	{ 0x80, "RES", 1, 8, &CPU::reset_bit<0x80> },
+	{ 0x81, "RES", 1, 8, &CPU::reset_bit<0x81> },
+	{ 0x82, "RES", 1, 8, &CPU::reset_bit<0x82> },
+	{ 0x83, "RES", 1, 8, &CPU::reset_bit<0x83> },
+	{ 0x84, "RES", 1, 8, &CPU::reset_bit<0x84> },
+	{ 0x85, "RES", 1, 8, &CPU::reset_bit<0x85> },
+	{ 0x86, "RES", 1, 16, &CPU::reset_bit<0x86> },
+	{ 0x87, "RES", 1, 8, &CPU::reset_bit<0x87> },
+	{ 0x88, "RES", 1, 8, &CPU::reset_bit<0x88> },
+	{ 0x89, "RES", 1, 8, &CPU::reset_bit<0x89> },
+	{ 0x8A, "RES", 1, 8, &CPU::reset_bit<0x8A> },
+	{ 0x8B, "RES", 1, 8, &CPU::reset_bit<0x8B> },
+	{ 0x8C, "RES", 1, 8, &CPU::reset_bit<0x8C> },
+	{ 0x8D, "RES", 1, 8, &CPU::reset_bit<0x8D> },
+	{ 0x8E, "RES", 1, 16, &CPU::reset_bit<0x8E> },
+	{ 0x8F, "RES", 1, 8, &CPU::reset_bit<0x8F> },
+
+	{ 0x90, "RES", 1, 8, &CPU::reset_bit<0x90> },
+	{ 0x91, "RES", 1, 8, &CPU::reset_bit<0x91> },
+	{ 0x92, "RES", 1, 8, &CPU::reset_bit<0x92> },
+	{ 0x93, "RES", 1, 8, &CPU::reset_bit<0x93> },
+	{ 0x94, "RES", 1, 8, &CPU::reset_bit<0x94> },
+	{ 0x95, "RES", 1, 8, &CPU::reset_bit<0x95> },
+	{ 0x96, "RES", 1, 16, &CPU::reset_bit<0x96> },
+	{ 0x97, "RES", 1, 8, &CPU::reset_bit<0x97> },
+	{ 0x98, "RES", 1, 8, &CPU::reset_bit<0x98> },
+	{ 0x99, "RES", 1, 8, &CPU::reset_bit<0x99> },
+	{ 0x9A, "RES", 1, 8, &CPU::reset_bit<0x9A> },
+	{ 0x9B, "RES", 1, 8, &CPU::reset_bit<0x9B> },
+	{ 0x9C, "RES", 1, 8, &CPU::reset_bit<0x9C> },
+	{ 0x9D, "RES", 1, 8, &CPU::reset_bit<0x9D> },
+	{ 0x9E, "RES", 1, 16, &CPU::reset_bit<0x9E> },
+	{ 0x9F, "RES", 1, 8, &CPU::reset_bit<0x9F> },
+
+	{ 0xA0, "RES", 1, 8, &CPU::reset_bit<0xA0> },
+	{ 0xA1, "RES", 1, 8, &CPU::reset_bit<0xA1> },
+	{ 0xA2, "RES", 1, 8, &CPU::reset_bit<0xA2> },
+	{ 0xA3, "RES", 1, 8, &CPU::reset_bit<0xA3> },
+	{ 0xA4, "RES", 1, 8, &CPU::reset_bit<0xA4> },
+	{ 0xA5, "RES", 1, 8, &CPU::reset_bit<0xA5> },
+	{ 0xA6, "RES", 1, 16, &CPU::reset_bit<0xA6> },
+	{ 0xA7, "RES", 1, 8, &CPU::reset_bit<0xA7> },
+	{ 0xA8, "RES", 1, 8, &CPU::reset_bit<0xA8> },
+	{ 0xA9, "RES", 1, 8, &CPU::reset_bit<0xA9> },
+	{ 0xAA, "RES", 1, 8, &CPU::reset_bit<0xAA> },
+	{ 0xAB, "RES", 1, 8, &CPU::reset_bit<0xAB> },
+	{ 0xAC, "RES", 1, 8, &CPU::reset_bit<0xAC> },
+	{ 0xAD, "RES", 1, 8, &CPU::reset_bit<0xAD> },
+	{ 0xAE, "RES", 1, 16, &CPU::reset_bit<0xAE> },
+	{ 0xAF, "RES", 1, 8, &CPU::reset_bit<0xAF> },
+
+	{ 0xB0, "RES", 1, 8, &CPU::reset_bit<0xB0> },
+	{ 0xB1, "RES", 1, 8, &CPU::reset_bit<0xB1> },
+	{ 0xB2, "RES", 1, 8, &CPU::reset_bit<0xB2> },
+	{ 0xB3, "RES", 1, 8, &CPU::reset_bit<0xB3> },
+	{ 0xB4, "RES", 1, 8, &CPU::reset_bit<0xB4> },
+	{ 0xB5, "RES", 1, 8, &CPU::reset_bit<0xB5> },
+	{ 0xB6, "RES", 1, 16, &CPU::reset_bit<0xB6> },
+	{ 0xB7, "RES", 1, 8, &CPU::reset_bit<0xB7> },
+	{ 0xB8, "RES", 1, 8, &CPU::reset_bit<0xB8> },
+	{ 0xB9, "RES", 1, 8, &CPU::reset_bit<0xB9> },
+	{ 0xBA, "RES", 1, 8, &CPU::reset_bit<0xBA> },
+	{ 0xBB, "RES", 1, 8, &CPU::reset_bit<0xBB> },
+	{ 0xBC, "RES", 1, 8, &CPU::reset_bit<0xBC> },
+	{ 0xBD, "RES", 1, 8, &CPU::reset_bit<0xBD> },
+	{ 0xBE, "RES", 1, 16, &CPU::reset_bit<0xBE> },
+	{ 0xBF, "RES", 1, 8, &CPU::reset_bit<0xBF> },
+
+	{ 0xC0, "SET", 1, 8, &CPU::set_bit<0xC0> },
+	{ 0xC1, "SET", 1, 8, &CPU::set_bit<0xC1> },
+	{ 0xC2, "SET", 1, 8, &CPU::set_bit<0xC2> },
+	{ 0xC3, "SET", 1, 8, &CPU::set_bit<0xC3> },
+	{ 0xC4, "SET", 1, 8, &CPU::set_bit<0xC4> },
+	{ 0xC5, "SET", 1, 8, &CPU::set_bit<0xC5> },
+	{ 0xC6, "SET", 1, 16, &CPU::set_bit<0xC6> },
+	{ 0xC7, "SET", 1, 8, &CPU::set_bit<0xC7> },
+	{ 0xC8, "SET", 1, 8, &CPU::set_bit<0xC8> },
+	{ 0xC9, "SET", 1, 8, &CPU::set_bit<0xC9> },
+	{ 0xCA, "SET", 1, 8, &CPU::set_bit<0xCA> },
+	{ 0xCB, "SET", 1, 8, &CPU::set_bit<0xCB> },
+	{ 0xCC, "SET", 1, 8, &CPU::set_bit<0xCC> },
+	{ 0xCD, "SET", 1, 8, &CPU::set_bit<0xCD> },
+	{ 0xCE, "SET", 1, 16, &CPU::set_bit<0xCE> },
+	{ 0xCF, "SET", 1, 8, &CPU::set_bit<0xCF> },
+
+	{ 0xD0, "SET", 1, 8, &CPU::set_bit<0xD0> },
+	{ 0xD1, "SET", 1, 8, &CPU::set_bit<0xD1> },
+	{ 0xD2, "SET", 1, 8, &CPU::set_bit<0xD2> },
+	{ 0xD3, "SET", 1, 8, &CPU::set_bit<0xD3> },
+	{ 0xD4, "SET", 1, 8, &CPU::set_bit<0xD4> },
+	{ 0xD5, "SET", 1, 8, &CPU::set_bit<0xD5> },
+	{ 0xD6, "SET", 1, 16, &CPU::set_bit<0xD6> },
+	{ 0xD7, "SET", 1, 8, &CPU::set_bit<0xD7> },
+	{ 0xD8, "SET", 1, 8, &CPU::set_bit<0xD8> },
+	{ 0xD9, "SET", 1, 8, &CPU::set_bit<0xD9> },
+	{ 0xDA, "SET", 1, 8, &CPU::set_bit<0xDA> },
+	{ 0xDB, "SET", 1, 8, &CPU::set_bit<0xDB> },
+	{ 0xDC, "SET", 1, 8, &CPU::set_bit<0xDC> },
+	{ 0xDD, "SET", 1, 8, &CPU::set_bit<0xDD> },
+	{ 0xDE, "SET", 1, 16, &CPU::set_bit<0xDE> },
+	{ 0xDF, "SET", 1, 8, &CPU::set_bit<0xDF> },
+
+	{ 0xE0, "SET", 1, 8, &CPU::set_bit<0xE0> },
+	{ 0xE1, "SET", 1, 8, &CPU::set_bit<0xE1> },
+	{ 0xE2, "SET", 1, 8, &CPU::set_bit<0xE2> },
+	{ 0xE3, "SET", 1, 8, &CPU::set_bit<0xE3> },
+	{ 0xE4, "SET", 1, 8, &CPU::set_bit<0xE4> },
+	{ 0xE5, "SET", 1, 8, &CPU::set_bit<0xE5> },
+	{ 0xE6, "SET", 1, 16, &CPU::set_bit<0xE6> },
+	{ 0xE7, "SET", 1, 8, &CPU::set_bit<0xE7> },
+	{ 0xE8, "SET", 1, 8, &CPU::set_bit<0xE8> },
+	{ 0xE9, "SET", 1, 8, &CPU::set_bit<0xE9> },
+	{ 0xEA, "SET", 1, 8, &CPU::set_bit<0xEA> },
+	{ 0xEB, "SET", 1, 8, &CPU::set_bit<0xEB> },
+	{ 0xEC, "SET", 1, 8, &CPU::set_bit<0xEC> },
+	{ 0xED, "SET", 1, 8, &CPU::set_bit<0xED> },
+	{ 0xEE, "SET", 1, 16, &CPU::set_bit<0xEE> },
+	{ 0xEF, "SET", 1, 8, &CPU::set_bit<0xEF> },
+
+	{ 0xF0, "SET", 1, 8, &CPU::set_bit<0xF0> },
+	{ 0xF1, "SET", 1, 8, &CPU::set_bit<0xF1> },
+	{ 0xF2, "SET", 1, 8, &CPU::set_bit<0xF2> },
+	{ 0xF3, "SET", 1, 8, &CPU::set_bit<0xF3> },
+	{ 0xF4, "SET", 1, 8, &CPU::set_bit<0xF4> },
+	{ 0xF5, "SET", 1, 8, &CPU::set_bit<0xF5> },
+	{ 0xF6, "SET", 1, 16, &CPU::set_bit<0xF6> },
+	{ 0xF7, "SET", 1, 8, &CPU::set_bit<0xF7> },
+	{ 0xF8, "SET", 1, 8, &CPU::set_bit<0xF8> },
+	{ 0xF9, "SET", 1, 8, &CPU::set_bit<0xF9> },
+	{ 0xFA, "SET", 1, 8, &CPU::set_bit<0xFA> },
+	{ 0xFB, "SET", 1, 8, &CPU::set_bit<0xFB> },
+	{ 0xFC, "SET", 1, 8, &CPU::set_bit<0xFC> },
+	{ 0xFD, "SET", 1, 8, &CPU::set_bit<0xFD> },
+	{ 0xFE, "SET", 1, 16, &CPU::set_bit<0xFE> },
+	{ 0xFF, "SET", 1, 8, &CPU::set_bit<0xFF> },
 
 };
\ No newline at end of file
@@ -0,0 +1,569 @@
+#ifndef _INSTRUCTIONS_H_
+#define _INSTRUCTIONS_H_
+
+#include "cpu.h"
+
+#include "gameboy.h"
+
+#include "memory.h"
+
+#include "debug.h"
+
+// Handlers that depend on the opcode are instantiated once per opcode by the instruction maps,
+// which lets the compiler resolve the operand and condition selection at compile time.
+namespace libdmg
+{
+	template <uint8_t opcode>
+	DMG_INLINE uint8_t CPU::ReadSourceValue(const uint8_t* operands) const
+	{
+		if (opcode > 0xC0 && (opcode % 8) == 0x6)
+			return operands[0];
+
+		return ReadOperand<opcode % 8>();
+	}
+
+	template <uint8_t index>
+	DMG_INLINE uint8_t CPU::ReadOperand() const
+	{
+		switch (index)
+		{
+			case 0x0: return registers.b;
+			case 0x1: return registers.c;
+			case 0x2: return registers.d;
+			case 0x3: return registers.e;
+			case 0x4: return registers.h;
+			case 0x5: return registers.l;
+			case 0x7: return registers.a;
+
+			case 0x6: return memory.ReadByte(registers.hl);
+		}
+	}
+
+	template <uint8_t index>
+	DMG_INLINE void CPU::WriteOperand(uint8_t value)
+	{
+		switch (index)
+		{
+			case 0x0: registers.b = value; break;
+			case 0x1: registers.c = value; break;
+			case 0x2: registers.d = value; break;
+			case 0x3: registers.e = value; break;
+			case 0x4: registers.h = value; break;
+			case 0x5: registers.l = value; break;
+			case 0x7: registers.a = value; break;
+
+			case 0x6: memory.WriteByte(registers.hl, value); break;
+		}
+	}
+
+	template <uint8_t opcode>
+	void CPU::jump_conditional(uint8_t, const uint8_t* operands)
+	{
+		bool conditional;
+
+		switch (opcode)
+		{
+			case 0xC2: conditional = !GetFlag(FLAG_ZERO); break;
+			case 0xCA: conditional = GetFlag(FLAG_ZERO); break;
+			case 0xD2: conditional = !GetFlag(FLAG_CARRY); break;
+			case 0xDA: conditional = GetFlag(FLAG_CARRY); break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+
+		if (conditional)
+			registers.pc = DECODE_SHORT(operands);
+	}
+
+	template <uint8_t opcode>
+	void CPU::jump_to_offset_conditional(uint8_t, const uint8_t* operands)
+	{
+		bool conditional;
+
+		switch (opcode)
+		{
+			case 0x20: conditional = !GetFlag(FLAG_ZERO); break;
+			case 0x28: conditional = GetFlag(FLAG_ZERO); break;
+			case 0x30: conditional = !GetFlag(FLAG_CARRY); break;
+			case 0x38: conditional = GetFlag(FLAG_CARRY); break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+
+		if (conditional)
+			registers.pc += DECODE_SIGNED_BYTE(operands);
+	}
+
+	template <uint8_t opcode>
+	void CPU::call_conditional(uint8_t, const uint8_t* operands)
+	{
+		bool conditional;
+
+		switch (opcode)
+		{
+			case 0xC4: conditional = !GetFlag(FLAG_ZERO); break;
+			case 0xCC: conditional = GetFlag(FLAG_ZERO); break;
+			case 0xD4: conditional = !GetFlag(FLAG_CARRY); break;
+			case 0xDC: conditional = GetFlag(FLAG_CARRY); break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+		if (conditional)
+		{
+			WriteStackShort(registers.pc);
+			registers.pc = DECODE_SHORT(operands);
+		}
+	}
+
+	template <uint8_t opcode>
+	void CPU::restart(uint8_t, const uint8_t* operands)
+	{
+		assert(opcode > 0xC0 && opcode <= 0xFF && (opcode % 16 == 7 || opcode % 16 == 15));
+
+		WriteStackShort(registers.pc);
+		registers.pc = opcode - 0xC7;
+	}
+
+	template <uint8_t opcode>
+	void CPU::return_conditional(uint8_t, const uint8_t* operands)
+	{
+		bool conditional;
+
+		switch (opcode)
+		{
+			case 0xC0: conditional = !GetFlag(FLAG_ZERO); break;
+			case 0xC8: conditional = GetFlag(FLAG_ZERO); break;
+			case 0xD0: conditional = !GetFlag(FLAG_CARRY); break;
+			case 0xD8: conditional = GetFlag(FLAG_CARRY); break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+
+		if (conditional)
+			registers.pc = ReadStackShort();
+
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_add(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		uint16_t result = registers.a + value;
+
+		DeferFlags(FLAG_OP_ADD, registers.a, value, result);
+
+		registers.a = (uint8_t) result;
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_adc(uint8_t, const uint8_t* operands)
+	{
+		uint8_t carry = GetFlag(FLAG_CARRY);
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		uint16_t result = registers.a + value + carry;
+
+		DeferFlags(FLAG_OP_ADD, registers.a, value, result);
+
+		registers.a = (uint8_t) result;
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_sub(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		uint16_t result = registers.a - value;
+
+		DeferFlags(FLAG_OP_SUB, registers.a, value, result);
+
+		registers.a = (uint8_t) result;
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_sbc(uint8_t, const uint8_t* operands)
+	{
+		uint8_t carry = GetFlag(FLAG_CARRY);
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		uint16_t result = registers.a - value - carry;
+
+		DeferFlags(FLAG_OP_SUB, registers.a, value, result);
+
+		registers.a = (uint8_t) result;
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_and(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		registers.a = registers.a & value;
+
+		DeferFlags(FLAG_OP_AND, 0, 0, registers.a);
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_or(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		registers.a = registers.a | value;
+
+		DeferFlags(FLAG_OP_OR, 0, 0, registers.a);
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_xor(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		registers.a = registers.a ^ value;
+
+		DeferFlags(FLAG_OP_OR, 0, 0, registers.a);
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_cmp(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		uint16_t result = registers.a - value;
+
+		DeferFlags(FLAG_OP_SUB, registers.a, value, result);
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_inc(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadOperand<(opcode >> 3) & 0x7>();
+		uint8_t result = value + 1;
+
+		// INC doesn't affect the carry flag, so it is carried over from the previous operation
+		flagCarry = GetFlag(FLAG_CARRY);
+		DeferFlags(FLAG_OP_INC, 0, 0, result);
+
+		WriteOperand<(opcode >> 3) & 0x7>(result);
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_dec(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadOperand<(opcode >> 3) & 0x7>();
+		uint8_t result = value - 1;
+
+		// DEC doesn't affect the carry flag, so it is carried over from the previous operation
+		flagCarry = GetFlag(FLAG_CARRY);
+		DeferFlags(FLAG_OP_DEC, 0, 0, result);
+
+		WriteOperand<(opcode >> 3) & 0x7>(result);
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_inc_16bit(uint8_t, const uint8_t* operands)
+	{
+		switch (opcode >> 4)
+		{
+			case 0x0: ++registers.bc; break;
+			case 0x1: ++registers.de; break;
+			case 0x2: ++registers.hl; break;
+			case 0x3: ++registers.sp; break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_dec_16bit(uint8_t, const uint8_t* operands)
+	{
+		switch (opcode >> 4)
+		{
+			case 0x0: --registers.bc; break;
+			case 0x1: --registers.de; break;
+			case 0x2: --registers.hl; break;
+			case 0x3: --registers.sp; break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+
+	}
+
+	template <uint8_t opcode>
+	void CPU::alu_add_hl_16bit(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint16_t value;
+
+		switch (opcode)
+		{
+			case 0x09: value = registers.bc; break;
+			case 0x19: value = registers.de; break;
+			case 0x29: value = registers.hl; break;
+			case 0x39: value = registers.sp; break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+
+		uint16_t result = registers.hl + value;
+
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = SET_MASK_IF(registers.f, FLAG_HALF_CARRY, CARRY_BIT_12(registers.hl, value, result));
+		registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, OVERFLOW_16(registers.hl, value, result));
+
+		registers.hl = result;
+	}
+
+	template <uint8_t opcode>
+	void CPU::load_constant(uint8_t, const uint8_t* operands)
+	{
+		WriteOperand<(opcode >> 3) & 0x7>(operands[0]);
+	}
+
+	template <uint8_t opcode>
+	void CPU::load_memory_to_memory(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadSourceValue<opcode>(operands);
+		WriteOperand<(opcode >> 3) & 0x7>(value);
+	}
+
+	template <uint8_t opcode>
+	void CPU::load_accumulator_to_memory(uint8_t, const uint8_t* operands)
+	{
+		switch (opcode / 16)
+		{
+			case 0x0: memory.WriteByte(registers.bc, registers.a); break;
+			case 0x1: memory.WriteByte(registers.de, registers.a); break;
+			case 0x2: memory.WriteByte(registers.hl, registers.a); ++registers.hl; break;
+			case 0x3: memory.WriteByte(registers.hl, registers.a); --registers.hl; break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+	}
+
+	template <uint8_t opcode>
+	void CPU::load_memory_to_accumulator(uint8_t, const uint8_t* operands)
+	{
+		switch (opcode / 16)
+		{
+			case 0x0: memory.Read(registers.bc, registers.a); break;
+			case 0x1: memory.Read(registers.de, registers.a); break;
+			case 0x2: memory.Read(registers.hl, registers.a); ++registers.hl; break;
+			case 0x3: memory.Read(registers.hl, registers.a); --registers.hl; break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+
+	}
+
+	template <uint8_t opcode>
+	void CPU::load_constant_16bit(uint8_t, const uint8_t* operands)
+	{
+		switch (opcode)
+		{
+			case 0x01: registers.bc = DECODE_SHORT(operands); break;
+			case 0x11: registers.de = DECODE_SHORT(operands); break;
+			case 0x21: registers.hl = DECODE_SHORT(operands); break;
+			case 0x31: registers.sp = DECODE_SHORT(operands); break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+	}
+
+	template <uint8_t opcode>
+	void CPU::push_stack_16bit(uint8_t, const uint8_t* operands)
+	{
+		switch (opcode)
+		{
+			case 0xC5: WriteStackShort(registers.bc); break;
+			case 0xD5: WriteStackShort(registers.de); break;
+			case 0xE5: WriteStackShort(registers.hl); break;
+			case 0xF5: MaterializeFlags(); WriteStackShort(registers.af); break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+	}
+
+	template <uint8_t opcode>
+	void CPU::pop_stack_16bit(uint8_t, const uint8_t* operands)
+	{
+		switch (opcode)
+		{
+			case 0xC1: registers.bc = ReadStackShort(); break;
+			case 0xD1: registers.de = ReadStackShort(); break;
+			case 0xE1: registers.hl = ReadStackShort(); break;
+		
+			case 0xF1: 
+				// POP AF clears the lower nibble of the F register, which seems to be undocumented behaviour
+				flagOperation = FLAG_OP_NONE;
+				registers.af = ReadStackShort() & 0xFFF0; 
+				break;
+
+			default: assert(false && "Invalid opcode for handler!");
+		}
+	}
+
+	template <uint8_t opcode>
+	void CPU::rotate_left(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+		uint8_t bit7 = READ_BIT(value, 7);
+		uint8_t result = (value << 1) | READ_MASK(registers.f, FLAG_CARRY);
+
+		WriteOperand<opcode % 8>(result);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit7);
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::rotate_right(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+		uint8_t bit0 = READ_BIT(value, 0);
+		uint8_t result = (value >> 1) | (READ_MASK(registers.f, FLAG_CARRY) << 7);
+
+		WriteOperand<opcode % 8>(result);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit0);
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::rotate_left_circular(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+		uint8_t bit7 = READ_BIT(value, 7);
+		uint8_t result = (value << 1) | bit7;
+
+		WriteOperand<opcode % 8>(result);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit7);
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::rotate_right_circular(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+		uint8_t bit0 = READ_BIT(value, 0);
+		uint8_t result = (value >> 1) | (bit0 << 7);
+
+		WriteOperand<opcode % 8>(result);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit0);
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::shift_left_arithmetically(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+		uint8_t bit7 = READ_BIT(value, 7);
+		uint8_t result = value << 1;
+
+		WriteOperand<opcode % 8>(result);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit7);
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::shift_right_arithmetically(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+		uint8_t bit7 = READ_BIT(value, 7);
+		uint8_t bit0 = READ_BIT(value, 0);
+		uint8_t result = SET_BIT_IF(value >> 1, 7, bit7);
+
+		WriteOperand<opcode % 8>(result);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit0);
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::shift_right_logically(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+		uint8_t bit0 = READ_BIT(value, 0);
+		uint8_t result = value >> 1;
+
+		WriteOperand<opcode % 8>(result);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_CARRY, bit0);
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::swap(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+		uint8_t result = (value << 4) | (value >> 4);
+
+		WriteOperand<opcode % 8>(result);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = UNSET_MASK(registers.f, FLAG_HALF_CARRY);
+		registers.f = UNSET_MASK(registers.f, FLAG_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::test_bit(uint8_t, const uint8_t* operands)
+	{
+		MaterializeFlags();
+
+		uint8_t value = ReadOperand<opcode % 8>();
+
+		uint8_t bit = (opcode - 0x40) / 8;
+		uint8_t result = READ_BIT(value, bit);
+
+		registers.f = SET_MASK_IF(registers.f, FLAG_ZERO, result == 0);
+		registers.f = UNSET_MASK(registers.f, FLAG_SUBTRACT);
+		registers.f = SET_MASK(registers.f, FLAG_HALF_CARRY);
+	}
+
+	template <uint8_t opcode>
+	void CPU::reset_bit(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadOperand<opcode % 8>();
+
+		uint8_t bit = (opcode - 0x80) / 8;
+		WriteOperand<opcode % 8>(UNSET_BIT(value, bit));
+	}
+
+	template <uint8_t opcode>
+	void CPU::set_bit(uint8_t, const uint8_t* operands)
+	{
+		uint8_t value = ReadOperand<opcode % 8>();
+
+		uint8_t bit = (opcode - 0xC0) / 8;
+		WriteOperand<opcode % 8>(SET_BIT(value, bit));
+	}
+}
+
+#endif
\ No newline at end of file
@@ -13,6 +13,10 @@
 #include "audio.h"
 #include "input.h"
 #include "ringbuffer.h"
+#include "audiosink.h"
+#include "audiostream.h"
+#include "wavfilesink.h"
+#include "breakpoints.h"
 
 #include "emulator.h"
 
@@ -10,9 +10,11 @@ MBC::MBC(MBC::Type type, Cartridge& cartridge) :
 	rom(*this), ram(*this),
 	ramEnabled(false), ramBankMode(false), 
 	ramDirty(false),
-	selectedROMBank(1), selectedRAMBank(0)
+	selectedROMBank(1), selectedRAMBank(0),
+	romBank0(NULL), romBankX(NULL), ramBank(NULL), ramMapped(false),
+	listener(NULL)
 {
-
+	UpdateBanks();
 }
 
 MBC::ROM::ROM(MBC& mbc) : mbc(mbc)
@@ -37,6 +39,24 @@ void MBC::WriteRegister(uint16_t address, uint8_t value)
 		WriteRegisterMBC5(address, value);
 		break;
 	}
+
+	UpdateBanks();
+}
+
+void MBC::UpdateBanks()
+{
+	const uint8_t* selectedROM = rom.GetBank(selectedROMBank);
+	uint8_t* selectedRAM = ram.Size() > 0 ? cartridge.ram + (selectedRAMBank << 13) : NULL;
+
+	bool switched = romBankX != selectedROM || ramBank != selectedRAM || ramMapped != ramEnabled;
+
+	romBank0 = rom.GetBank(0);
+	romBankX = selectedROM;
+	ramBank = selectedRAM;
+	ramMapped = ramEnabled;
+
+	if (switched && listener != NULL)
+		listener->BanksSwitched(*this);
 }
 
 void MBC::WriteRegisterMBC1(uint16_t address, uint8_t value)
@@ -190,8 +210,8 @@ const uint32_t MBC::ROM::Size() const
 
 uint8_t MBC::ROM::ReadByte(uint16_t address) const
 {
-	const uint8_t* bank = GetBank(address >= 0x4000 ? mbc.selectedROMBank : 0);
-	return *(bank + (address % 0x4000));
+	const uint8_t* bank = address >= 0x4000 ? mbc.romBankX : mbc.romBank0;
+	return bank[address & 0x3FFF];
 }
 
 void MBC::ROM::WriteByte(uint16_t address, uint8_t value)
@@ -217,10 +237,10 @@ uint32_t MBC::RAM::Size() const { return size; }
 
 uint8_t MBC::RAM::ReadByte(uint16_t address) const
 {
-	if (!mbc.ramEnabled)
+	if (!mbc.ramEnabled || mbc.ramBank == NULL)
 		return 0xFF;
 
-	return GetCurrentBank()[address];
+	return mbc.ramBank[address];
 }
 
 void MBC::RAM::WriteByte(uint16_t address, uint8_t value)
@@ -228,9 +248,9 @@ void MBC::RAM::WriteByte(uint16_t address, uint8_t value)
 	if (!mbc.ramEnabled)
 		return;
 
-	assert(size > 0);
+	assert(mbc.ramBank != NULL);
 
 	mbc.ramDirty = true;
 
-	WRITE_BYTE(GetCurrentBank() + address, value);
+	WRITE_BYTE(mbc.ramBank + address, value);
 }
\ No newline at end of file
@@ -7,6 +7,14 @@
 
 namespace libdmg
 {
+	class MBC;
+
+	// Notified whenever the MBC maps a different ROM or RAM bank, or enables/disables RAM
+	class BankListener
+	{
+	public:
+		virtual void BanksSwitched(MBC& mbc) = 0;
+	};
 
 	class MBC
 	{
@@ -38,7 +46,6 @@ namespace libdmg
 
 			void WriteByte(uint16_t address, uint8_t value);
 
-		private:
 			const uint8_t* GetBank(uint16_t bank) const { return mbc.cartridge.rom + (0x4000 * bank); }
 
 		};
@@ -59,10 +66,6 @@ namespace libdmg
 			uint8_t ReadByte(uint16_t address) const;
 
 			void WriteByte(uint16_t address, uint8_t value);
-
-		private:
-			uint8_t* GetCurrentBank() { return const_cast<uint8_t*>(static_cast<const RAM*>(this)->GetCurrentBank()); }
-			const uint8_t* GetCurrentBank() const { return mbc.cartridge.ram + (mbc.selectedRAMBank << 10); }
 		};
 
 	private:
@@ -78,20 +81,40 @@ namespace libdmg
 
 		uint8_t selectedRAMBank;
 
+		// Host pointers to the currently mapped banks, only updated when a bank register is written
+		const uint8_t* romBank0;
+		const uint8_t* romBankX;
+		uint8_t* ramBank;
+		bool ramMapped;
+
+		BankListener* listener;
+
 	public:
 		ROM rom;
 		RAM ram;
 
+		bool IsRamEnabled() const { return ramEnabled; }
+
+		const uint8_t* FixedROMBank() const { return romBank0; }
+		const uint8_t* SelectedROMBank() const { return romBankX; }
+		uint16_t SelectedROMBankNumber() const { return selectedROMBank; }
+		uint8_t* SelectedRAMBank() const { return ramBank; }
+
 		bool IsRamDirty() const { return ramDirty; }
 		void ClearRamDirty() { ramDirty = false; }
 
 	public:
 		MBC(Type type, Cartridge& cartridge);
 
+		void BindListener(BankListener* listener) { this->listener = listener; }
+
 		void WriteRegister(uint16_t address, uint8_t value);
 		void WriteRegisterMBC1(uint16_t address, uint8_t value);
 		void WriteRegisterMBC3(uint16_t address, uint8_t value);
 		void WriteRegisterMBC5(uint16_t address, uint8_t value);
+
+	private:
+		void UpdateBanks();
 	};
 }
 
@@ -9,20 +9,23 @@
 #include "mbc.h"
 
 #include "cartridge.h"
+#include "dma.h"
+
+#include <string.h>
 
 using namespace libdmg;
 
 uint16_t null;
 
-Memory::Memory() : MemoryWriteCallback(NULL), mbc(NULL)
+Memory::Memory() : mbc(NULL), busLocked(false), watchedPageCount(0), synchronizer(NULL), videoMemoryListener(NULL), watchListener(NULL)
 {
 	MemoryBuffer* vramBuffer	= new MemoryBuffer(0x2000);
 	MemoryBuffer* wramBuffer	= new MemoryBuffer(0x2000);
 
-	MemoryBuffer* oamBuffer		= new MemoryBuffer(0x9F);
-	MemoryBuffer* hramBuffer	= new MemoryBuffer(0xF1);
+	MemoryBuffer* oamBuffer		= new MemoryBuffer(0xA0);
+	MemoryBuffer* hramBuffer	= new MemoryBuffer(0x7F);
 
-	MemoryBuffer* naBuffer		= new MemoryBuffer(0x5F);
+	MemoryBuffer* naBuffer		= new MemoryBuffer(0x60);
 
 	banks = new MemoryRange[MEMORY_BANK_COUNT];
 
@@ -35,14 +38,34 @@ Memory::Memory() : MemoryWriteCallback(NULL), mbc(NULL)
 	banks[currentBank++] = { 0xFE00, 0xFE9F, oamBuffer };
 	banks[currentBank++] = { 0xFEA0, 0xFEFF, naBuffer };
 	banks[currentBank++] = { 0xFF00, 0xFF00, NULL };
-	banks[currentBank++] = { 0xFF01, 0xFF0F, new MemoryBuffer(0x09) };
+	banks[currentBank++] = { 0xFF01, 0xFF0F, new MemoryBuffer(0x0F) };
 	banks[currentBank++] = { 0xFF10, 0xFF14, NULL };
 	banks[currentBank++] = { 0xFF15, 0xFF19, NULL };
-	banks[currentBank++] = { 0xFF1A, 0xFF7F, new MemoryBuffer(0x65) };
+	banks[currentBank++] = { 0xFF1A, 0xFF45, new MemoryBuffer(0x2C) };
+	banks[currentBank++] = { 0xFF46, 0xFF46, NULL };
+	banks[currentBank++] = { 0xFF47, 0xFF7F, new MemoryBuffer(0x39) };
 	banks[currentBank++] = { 0xFF80, 0xFFFE, hramBuffer };
 	banks[currentBank++] = { 0xFFFF, 0xFFFF, new MemoryBuffer(0x01) };
 
 	assert(currentBank == MEMORY_BANK_COUNT);
+
+	oam = oamBuffer;
+	hram = hramBuffer;
+
+	for (uint16_t page = 0; page < PAGE_COUNT; ++page)
+	{
+		pageFlags[page] = 0;
+		codeGenerations[page] = 0;
+	}
+
+	memset(readWatches, 0, sizeof(readWatches));
+	memset(writeWatches, 0, sizeof(writeWatches));
+
+	// Plain memory is accessed directly through the page table, everything else goes through its memory bank
+	MapPages(0x00, PAGE_COUNT, NULL, NULL);
+	MapPages(GB_VRAM >> 8, 0x20, vramBuffer->Data(), vramBuffer->Data());
+	MapPages(GB_WRAM >> 8, 0x20, wramBuffer->Data(), wramBuffer->Data());
+	MapPages(GB_WRAM_ECHO >> 8, 0x1E, wramBuffer->Data(), wramBuffer->Data());
 }
 
 Memory::~Memory()
@@ -54,11 +77,12 @@ Memory::~Memory()
 	}
 }
 
-void Memory::BindIO(MemoryBank* input, MemoryBank* sound1, MemoryBank* sound2)
+void Memory::BindIO(MemoryBank* input, MemoryBank* sound1, MemoryBank* sound2, MemoryBank* dma)
 {
 	FindMemoryRange(GB_REG_JOYP)->bank = input;
 	FindMemoryRange(GB_REG_NR10)->bank = sound1;
 	FindMemoryRange(GB_REG_NR21)->bank = sound2;
+	FindMemoryRange(GB_REG_DMA)->bank = dma;
 }
 
 void Memory::BindCartridge(Cartridge& cartridge)
@@ -67,6 +91,7 @@ void Memory::BindCartridge(Cartridge& cartridge)
 	MemoryRange* ramRange = FindMemoryRange(GB_CRAM);
 
 	mbc = NULL;
+	this->cartridge = &cartridge;
 
 	switch (cartridge.header->cartridgeHardware)
 	{
@@ -127,6 +152,188 @@ void Memory::BindCartridge(Cartridge& cartridge)
 			assert(false && "Unsupported cartridge hardware");
 			break;
 	}
+
+	if (mbc != NULL)
+		mbc->BindListener(this);
+
+	MapCartridge();
+}
+
+void Memory::MapPages(uint8_t firstPage, uint16_t pageCount, const uint8_t* readData, uint8_t* writeData)
+{
+	for (uint16_t page = 0; page < pageCount; ++page)
+	{
+		mappedReadPages[firstPage + page] = readData != NULL ? readData + (page << 8) : NULL;
+		mappedWritePages[firstPage + page] = writeData != NULL ? writeData + (page << 8) : NULL;
+
+		UpdatePage(firstPage + page);
+	}
+}
+
+void Memory::SetPageFlags(uint8_t page, uint8_t flags)
+{
+	pageFlags[page] = flags;
+	UpdatePage(page);
+}
+
+void Memory::UpdatePage(uint8_t page)
+{
+	// Only read watches need reads to take the slow path, every flag does for writes
+	readPages[page] = (pageFlags[page] & PAGE_WATCH_READ) == 0 && !busLocked ? mappedReadPages[page] : NULL;
+	writePages[page] = pageFlags[page] == 0 && !busLocked ? mappedWritePages[page] : NULL;
+}
+
+void Memory::LockBus(bool locked)
+{
+	if (locked == busLocked)
+		return;
+
+	busLocked = locked;
+
+	for (uint16_t page = 0; page < PAGE_COUNT; ++page)
+		UpdatePage((uint8_t) page);
+}
+
+void Memory::ProtectCode(uint16_t address)
+{
+	uint8_t page = CanonicalPage(address >> 8);
+
+	// Writes to the ROM area of a cartridge with an MBC never modify the code
+	if (page < (GB_VRAM >> 8) && mbc != NULL)
+		return;
+
+	SetPageFlags(page, pageFlags[page] | PAGE_CODE);
+
+	if (page >= (GB_WRAM >> 8) && page < (GB_WRAM >> 8) + 0x1E)
+		SetPageFlags(page + 0x20, pageFlags[page + 0x20] | PAGE_CODE);
+}
+
+void Memory::BindVideoMemoryListener(VideoMemoryListener* listener)
+{
+	videoMemoryListener = listener;
+
+	uint8_t firstPage = GB_TILE_DATA_0 >> 8;
+	uint8_t pageCount = (GB_BG_MAP_0 - GB_TILE_DATA_0) >> 8;
+
+	for (uint8_t page = firstPage; page < firstPage + pageCount; ++page)
+		SetPageFlags(page, listener != NULL ? pageFlags[page] | PAGE_TILE_DATA : pageFlags[page] & ~PAGE_TILE_DATA);
+
+	uint8_t oamPage = GB_OAM >> 8;
+	SetPageFlags(oamPage, listener != NULL ? pageFlags[oamPage] | PAGE_OAM : pageFlags[oamPage] & ~PAGE_OAM);
+}
+
+void Memory::PageWritten(uint16_t address)
+{
+	uint8_t page = CanonicalPage(address >> 8);
+
+	if (pageFlags[page] & PAGE_TILE_DATA)
+		videoMemoryListener->TileDataWritten(address);
+
+	if ((pageFlags[page] & PAGE_OAM) && address < GB_OAM + GB_MAX_SPRITES * 4)
+		videoMemoryListener->OAMWritten();
+
+	if (pageFlags[page] & PAGE_CODE)
+	{
+		// Invalidate all code decoded from this page, it will be protected again when it is decoded
+		++codeGenerations[page];
+
+		SetPageFlags(page, pageFlags[page] & ~PAGE_CODE);
+
+		if (page >= (GB_WRAM >> 8) && page < (GB_WRAM >> 8) + 0x1E)
+			SetPageFlags(page + 0x20, pageFlags[page + 0x20] & ~PAGE_CODE);
+	}
+}
+
+void Memory::AddWatch(uint16_t start, uint16_t end, uint8_t kinds)
+{
+	SetWatch(start, end, kinds, true);
+}
+
+void Memory::RemoveWatch(uint16_t start, uint16_t end, uint8_t kinds)
+{
+	SetWatch(start, end, kinds, false);
+}
+
+void Memory::ClearWatches()
+{
+	SetWatch(0x0000, 0xFFFF, WATCH_ACCESS, false);
+}
+
+void Memory::SetWatch(uint16_t start, uint16_t end, uint8_t kinds, bool watched)
+{
+	assert(start <= end);
+
+	// Watches on echo RAM are set on the WRAM address it mirrors
+	for (uint32_t address = start; address <= end; ++address)
+	{
+		uint16_t canonicalAddress = CanonicalAddress((uint16_t) address);
+		uint32_t bit = 1U << (canonicalAddress & 0x1F);
+
+		if (kinds & WATCH_READ)
+			readWatches[canonicalAddress >> 5] = watched ? readWatches[canonicalAddress >> 5] | bit : readWatches[canonicalAddress >> 5] & ~bit;
+
+		if (kinds & WATCH_WRITE)
+			writeWatches[canonicalAddress >> 5] = watched ? writeWatches[canonicalAddress >> 5] | bit : writeWatches[canonicalAddress >> 5] & ~bit;
+	}
+
+	watchedPageCount = 0;
+
+	// Both the WRAM and echo pages of a watch are flagged, so every page is updated
+	for (uint16_t page = 0; page < PAGE_COUNT; ++page)
+	{
+		UpdateWatchFlags((uint8_t) page);
+
+		if (pageFlags[page] & (PAGE_WATCH_READ | PAGE_WATCH_WRITE))
+			++watchedPageCount;
+	}
+}
+
+void Memory::UpdateWatchFlags(uint8_t page)
+{
+	uint8_t flags = pageFlags[page] & ~(PAGE_WATCH_READ | PAGE_WATCH_WRITE);
+	uint8_t canonicalPage = CanonicalPage(page);
+
+	// Every page covers eight words of the bitmaps
+	for (uint8_t word = 0; word < 8; ++word)
+	{
+		if (readWatches[(canonicalPage << 3) + word] != 0)
+			flags |= PAGE_WATCH_READ;
+
+		if (writeWatches[(canonicalPage << 3) + word] != 0)
+			flags |= PAGE_WATCH_WRITE;
+	}
+
+	SetPageFlags(page, flags);
+}
+
+void Memory::WatchTriggered(uint16_t address, uint8_t value, WatchKind kind) const
+{
+	const uint32_t* watches = kind == WATCH_READ ? readWatches : writeWatches;
+
+	if (watchListener != NULL && TestWatch(watches, CanonicalAddress(address)))
+		watchListener->MemoryWatched(address, value, kind);
+}
+
+void Memory::MapCartridge()
+{
+	// Writes to the ROM area are MBC register writes, and cartridge RAM writes need to mark the RAM as dirty,
+	// so only reads can bypass the memory banks.
+	if (mbc != NULL)
+	{
+		MapPages(GB_ROM >> 8, 0x40, mbc->FixedROMBank(), NULL);
+		MapPages((GB_ROM >> 8) + 0x40, 0x40, mbc->SelectedROMBank(), NULL);
+		MapPages(GB_CRAM >> 8, 0x20, mbc->IsRamEnabled() ? mbc->SelectedRAMBank() : NULL, NULL);
+	}
+	else
+	{
+		MapPages(GB_ROM >> 8, 0x80, cartridge->rom, NULL);
+		MapPages(GB_CRAM >> 8, 0x20, NULL, NULL);
+	}
+}
+
+void Memory::BanksSwitched(MBC& mbc)
+{
+	MapCartridge();
 }
 
 const Memory::MemoryRange* Memory::FindMemoryRange(uint16_t address) const
@@ -146,33 +353,52 @@ const Memory::MemoryRange* Memory::FindMemoryRange(uint16_t address) const
 	return range;
 }
 
-void Memory::WriteByte(uint16_t address, uint8_t value)
+void Memory::WriteBankByte(uint16_t address, uint8_t value)
 {
-	if (MemoryWriteCallback != NULL)
-		MemoryWriteCallback(address);
+	// The CPU can't reach anything besides the IO registers and high RAM while the bus is locked
+	if (busLocked && address < GB_IO_REGISTERS)
+		return;
 
-	if (address == GB_REG_DMA)
-	{
-		Copy(value << 8, GB_OAM, 0x9F);
-	}
-	else
-	{
-		MemoryRange* range = FindMemoryRange(address);
-		range->bank->WriteByte(address - range->start, value);
-	}
+	SyncIO(address);
+
+	MemoryRange* range = FindMemoryRange(address);
+	range->bank->WriteByte(address - range->start, value);
+
+	PageWritten(address);
+
+	if (pageFlags[address >> 8] & PAGE_WATCH_WRITE)
+		WatchTriggered(address, value, WATCH_WRITE);
 }
 
 void Memory::WriteShort(uint16_t address, uint16_t value)
 {
-	if (MemoryWriteCallback != NULL)
+	uint8_t* page = writePages[address >> 8];
+
+	// Both bytes are written to the range of the first byte, so the fast path can only be used within a page
+	if (page != NULL && (address & 0xFF) != 0xFF)
 	{
-		MemoryWriteCallback(address);
-		MemoryWriteCallback(address + 1);
+		WRITE_BYTE(page + (address & 0xFF) + 0, value & 0xFF);
+		WRITE_BYTE(page + (address & 0xFF) + 1, value >> 8);
+		return;
 	}
 
+	if (busLocked && address < GB_IO_REGISTERS)
+		return;
+
+	SyncIO(address);
+
 	MemoryRange* range = FindMemoryRange(address);
 	range->bank->WriteByte(address - range->start + 0, value & 0xFF);
 	range->bank->WriteByte(address - range->start + 1, value >> 8);
+
+	PageWritten(address);
+	PageWritten(address + 1);
+
+	if (pageFlags[address >> 8] & PAGE_WATCH_WRITE)
+		WatchTriggered(address, value & 0xFF, WATCH_WRITE);
+
+	if (pageFlags[(uint16_t) (address + 1) >> 8] & PAGE_WATCH_WRITE)
+		WatchTriggered(address + 1, value >> 8, WATCH_WRITE);
 }
 
 void Memory::WriteBuffer(const uint8_t* srcBuffer, uint16_t startAddress, uint16_t size)
@@ -187,39 +413,82 @@ void Memory::Copy(uint16_t srcAddress, uint16_t dstAddress, uint16_t size)
 		WriteByte(dstAddress + offset, ReadByte(srcAddress + offset));
 }
 
-uint8_t Memory::ReadByte(uint16_t address) const
+void Memory::TransferOAM(uint8_t sourcePage)
 {
-	if (MemoryReadCallback != NULL)
-		MemoryReadCallback(address);
+	uint16_t srcAddress = sourcePage << 8;
+	const uint8_t* source = mappedReadPages[sourcePage];
 
-	const MemoryRange* range = FindMemoryRange(address);
-	return range->bank->ReadByte(address - range->start);
+	// Plain memory is copied in one go, anything else is read byte by byte through its memory bank
+	if (source != NULL)
+		memcpy(oam->Data(), source, DMA::TRANSFER_LENGTH);
+	else
+	{
+		for (uint16_t offset = 0; offset < DMA::TRANSFER_LENGTH; ++offset)
+			oam->WriteByte(offset, ReadBankByte(srcAddress + offset));
+	}
+
+	PageWritten(GB_OAM);
 }
 
-uint16_t Memory::ReadShort(uint16_t address) const
+uint8_t Memory::ReadBankByte(uint16_t address) const
 {
-	if (MemoryReadCallback != NULL)
+	uint8_t value;
+
+	// High RAM shares its page with the IO registers, but doesn't need a range lookup
+	if (address >= GB_HIMEM && address < GB_REG_IE)
+		value = hram->ReadByte(address - GB_HIMEM);
+	else if (busLocked && address < GB_IO_REGISTERS)
+		value = 0xFF;
+	else
 	{
-		MemoryReadCallback(address);
-		MemoryReadCallback(address + 1);
+		SyncIO(address);
+
+		const MemoryRange* range = FindMemoryRange(address);
+		value = range->bank->ReadByte(address - range->start);
 	}
 
+	if (pageFlags[address >> 8] & PAGE_WATCH_READ)
+		WatchTriggered(address, value, WATCH_READ);
+
+	return value;
+}
+
+uint16_t Memory::ReadShort(uint16_t address) const
+{
+	const uint8_t* page = readPages[address >> 8];
+
+	// Both bytes are read from the range of the first byte, so the fast path can only be used within a page
+	if (page != NULL && (address & 0xFF) != 0xFF)
+		return page[(address & 0xFF) + 0] | (page[(address & 0xFF) + 1] << 8);
+
+	if (busLocked && address < GB_IO_REGISTERS)
+		return 0xFFFF;
+
+	SyncIO(address);
+
 	const MemoryRange* range = FindMemoryRange(address);
 	uint16_t result;
 	result = range->bank->ReadByte(address - range->start + 0);
 	result |= range->bank->ReadByte(address - range->start + 1) << 8;
 
+	if (pageFlags[address >> 8] & PAGE_WATCH_READ)
+		WatchTriggered(address, result & 0xFF, WATCH_READ);
+
+	if (pageFlags[(uint16_t) (address + 1) >> 8] & PAGE_WATCH_READ)
+		WatchTriggered(address + 1, result >> 8, WATCH_READ);
+
 	return result;
 }
 
-void Memory::Read(uint16_t address, uint8_t& value) const
+uint8_t Memory::PeekByte(uint16_t address) const
 {
-	value = ReadByte(address);
-}
+	const uint8_t* page = mappedReadPages[address >> 8];
 
-void Memory::Read(uint16_t address, uint16_t& value) const
-{
-	value = ReadShort(address);
+	if (page != NULL)
+		return page[address & 0xFF];
+
+	const MemoryRange* range = FindMemoryRange(address);
+	return range->bank != NULL ? range->bank->ReadByte(address - range->start) : 0xFF;
 }
 
 void Memory::ReadBuffer(uint8_t* buffer, uint16_t address, uint16_t length) const
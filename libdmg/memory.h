@@ -2,19 +2,61 @@
 #define _MEMORY_H_
 
 #include "environment.h"
+#include "gameboy.h"
+#include "util.h"
 
 #include "memorybank.h"
+#include "memorybuffer.h"
 #include "memorypointer.h"
+#include "mbc.h"
 
 namespace libdmg
 {
 	class Cartridge;
-	class MBC;
 
-	class Memory
+	// Implemented by the owner of the emulation clock, which brings the IO subsystems up to date before their registers are accessed
+	class IOSynchronizer
 	{
 	public:
-		static const uint8_t MEMORY_BANK_COUNT = 14;
+		virtual void SyncIO(uint16_t address) = 0;
+	};
+
+	enum WatchKind
+	{
+		WATCH_READ = 1,
+		WATCH_WRITE = 2,
+		WATCH_ACCESS = WATCH_READ | WATCH_WRITE,
+	};
+
+	// Implemented by the debugger, which is notified of every CPU access to a watched address
+	class WatchListener
+	{
+	public:
+		virtual void MemoryWatched(uint16_t address, uint8_t value, WatchKind kind) = 0;
+	};
+
+	// Implemented by the video controller, which keeps decoded copies of the tile data and sprite attributes
+	class VideoMemoryListener
+	{
+	public:
+		virtual void TileDataWritten(uint16_t address) = 0;
+		virtual void OAMWritten() = 0;
+	};
+
+	class Memory : public BankListener
+	{
+	public:
+		static const uint8_t MEMORY_BANK_COUNT = 16;
+		static const uint16_t PAGE_COUNT = 256;
+
+		enum PageFlags
+		{
+			PAGE_CODE = 1,		// Page contains decoded instructions, writes invalidate them
+			PAGE_TILE_DATA = 2,	// Page contains tile data, writes are reported to the video memory listener
+			PAGE_OAM = 4,		// Page contains the sprite attributes, writes are reported to the video memory listener
+			PAGE_WATCH_READ = 8,	// Page contains addresses watched for reads, which are tested in the slow path
+			PAGE_WATCH_WRITE = 16,	// Page contains addresses watched for writes
+		};
 
 		struct MemoryRange
 		{
@@ -22,49 +64,163 @@ namespace libdmg
 			MemoryBank* bank;
 		};
 
-		void (*MemoryWriteCallback)(uint16_t address);
-		void (*MemoryReadCallback)(uint16_t address);
-
 		MBC* mbc;
 
 	private:
 		
 		MemoryRange* banks;
 
+		Cartridge* cartridge;
+
+		// Host pointers for every 256 byte page that maps plain memory. 
+		// Pages without a pointer are accessed through the memory bank of their range.
+		const uint8_t* readPages[PAGE_COUNT];
+		uint8_t* writePages[PAGE_COUNT];
+
+		// While the bus is locked all accesses take the slow path, which only lets the IO registers and high RAM through
+		const uint8_t* mappedReadPages[PAGE_COUNT];
+		bool busLocked;
+
+		// Pages with flags set are always written through the slow path, so the flags can be handled there
+		uint8_t* mappedWritePages[PAGE_COUNT];
+		uint8_t pageFlags[PAGE_COUNT];
+
+		uint32_t codeGenerations[PAGE_COUNT];
+
+		// One bit per address for both kinds of watches, the page flags tell which pages have any of them set
+		uint32_t readWatches[0x10000 / 32];
+		uint32_t writeWatches[0x10000 / 32];
+		uint16_t watchedPageCount;
+
+		MemoryBuffer* oam;
+		MemoryBuffer* hram;
+
+		IOSynchronizer* synchronizer;
+		VideoMemoryListener* videoMemoryListener;
+		WatchListener* watchListener;
 
 	public:
 
 		Memory();
 		~Memory();
 
-		void BindIO(MemoryBank* input, MemoryBank* sound1, MemoryBank* sound2);
+		void BindIO(MemoryBank* input, MemoryBank* sound1, MemoryBank* sound2, MemoryBank* dma);
 		void BindCartridge(Cartridge& cartridge);
+		void BindSynchronizer(IOSynchronizer* synchronizer) { this->synchronizer = synchronizer; }
+		void BindVideoMemoryListener(VideoMemoryListener* listener);
+		void BindWatchListener(WatchListener* listener) { watchListener = listener; }
 
 		MemoryPointer RetrievePointer(uint16_t address)
 		{
 			return MemoryPointer(*this, address);
 		}
 
-		void WriteByte(uint16_t address, uint8_t value);
+		DMG_INLINE void WriteByte(uint16_t address, uint8_t value)
+		{
+			uint8_t* page = writePages[address >> 8];
+
+			if (page != NULL)
+				WRITE_BYTE(page + (address & 0xFF), value);
+			else
+				WriteBankByte(address, value);
+		}
+
 		void WriteShort(uint16_t address, uint16_t value);
 		void WriteBuffer(const uint8_t* srcBuffer, uint16_t startAddress, uint16_t size);
 		
 		void Copy(uint16_t srcAddress, uint16_t dstAddress, uint16_t size);
 
-		uint8_t ReadByte(uint16_t address) const;
+		// Copies the sprite attributes from the given page, as an OAM DMA transfer does
+		void TransferOAM(uint8_t sourcePage);
+
+		void LockBus(bool locked);
+		bool IsBusLocked() const { return busLocked; }
+
+		DMG_INLINE uint8_t ReadByte(uint16_t address) const
+		{
+			const uint8_t* page = readPages[address >> 8];
+
+			if (page != NULL)
+				return page[address & 0xFF];
+			
+			return ReadBankByte(address);
+		}
+
 		uint16_t ReadShort(uint16_t address) const;
 
-		void Read(uint16_t address, uint8_t& value) const;
-		void Read(uint16_t address, uint16_t& value) const;
+		DMG_INLINE void Read(uint16_t address, uint8_t& value) const { value = ReadByte(address); }
+		DMG_INLINE void Read(uint16_t address, uint16_t& value) const { value = ReadShort(address); }
 		
 		void ReadBuffer(uint8_t* buffer, uint16_t address, uint16_t length) const;
 
+		// Reads a byte for the debugger, without syncing the IO subsystems or triggering watches
+		uint8_t PeekByte(uint16_t address) const;
+
+		// Host pointer to the byte at the given address, or NULL if the address isn't plain memory
+		DMG_INLINE const uint8_t* RetrieveHostPointer(uint16_t address) const
+		{
+			const uint8_t* page = readPages[address >> 8];
+			return page != NULL ? page + (address & 0xFF) : NULL;
+		}
+
+		// Counter that is increased whenever a page containing code is written to
+		DMG_INLINE uint32_t CodeGeneration(uint16_t address) const { return codeGenerations[CanonicalPage(address >> 8)]; }
+
+		void ProtectCode(uint16_t address);
+
+		// Watches the given range of addresses, including the end, for the given kinds of access.
+		// Accesses to pages without watches keep using the page table, so watches cost nothing elsewhere.
+		void AddWatch(uint16_t start, uint16_t end, uint8_t kinds);
+		void RemoveWatch(uint16_t start, uint16_t end, uint8_t kinds);
+		void ClearWatches();
+
+		bool HasWatches() const { return watchedPageCount > 0; }
+
 		MemoryRange* FindMemoryRange(uint16_t address)
 		{
 			return const_cast<MemoryRange*>(static_cast<const Memory*>(this)->FindMemoryRange(address)); 
 		}
 
 		const MemoryRange* FindMemoryRange(uint16_t address) const;
+
+	private:
+		void MapPages(uint8_t firstPage, uint16_t pageCount, const uint8_t* readData, uint8_t* writeData);
+		void MapCartridge();
+
+		void BanksSwitched(MBC& mbc);
+
+		void SetPageFlags(uint8_t page, uint8_t flags);
+		void UpdatePage(uint8_t page);
+		void PageWritten(uint16_t address);
+
+		void SetWatch(uint16_t start, uint16_t end, uint8_t kinds, bool watched);
+		void UpdateWatchFlags(uint8_t page);
+		void WatchTriggered(uint16_t address, uint8_t value, WatchKind kind) const;
+
+		DMG_INLINE static bool TestWatch(const uint32_t* watches, uint16_t address)
+		{
+			return (watches[address >> 5] & (1U << (address & 0x1F))) != 0;
+		}
+
+		// Echo RAM shares its pages with WRAM
+		DMG_INLINE static uint8_t CanonicalPage(uint8_t page)
+		{
+			return page >= (GB_WRAM_ECHO >> 8) && page < (GB_OAM >> 8) ? page - 0x20 : page;
+		}
+
+		DMG_INLINE static uint16_t CanonicalAddress(uint16_t address)
+		{
+			return (CanonicalPage(address >> 8) << 8) | (address & 0xFF);
+		}
+
+		void WriteBankByte(uint16_t address, uint8_t value);
+		uint8_t ReadBankByte(uint16_t address) const;
+
+		DMG_INLINE void SyncIO(uint16_t address) const
+		{
+			if (synchronizer != NULL && address >= GB_IO_REGISTERS && address < GB_HIMEM)
+				synchronizer->SyncIO(address);
+		}
 	};
 }
 
@@ -16,7 +16,8 @@ namespace libdmg
 
 		MemoryBuffer(uint16_t size) : external(false)
 		{ 
-			buffer = new uint8_t[size];
+			// Cleared, so IO registers that the boot sequence doesn't set start the same on every run
+			buffer = new uint8_t[size]();
 		}
 
 		MemoryBuffer(uint8_t* buffer) : buffer(buffer), external(true)
@@ -33,6 +34,8 @@ namespace libdmg
 		DMG_FORCE_INLINE uint8_t ReadByte(uint16_t address) const { return buffer[address]; }
 		DMG_FORCE_INLINE void WriteByte(uint16_t address, uint8_t value) { WRITE_BYTE(buffer + address, value); }
 
+		uint8_t* Data() const { return buffer; }
+
 
 	};
 }
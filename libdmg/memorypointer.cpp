@@ -5,21 +5,6 @@
 
 using namespace libdmg;
 
-NativePointer::NativePointer(uint8_t* ptr) : ptr(ptr)
-{
-
-}
-
-uint8_t NativePointer::Read()
-{
-	return *ptr; 
-}
-
-void NativePointer::Write(uint8_t value)
-{
-	*ptr = value; 
-}
-
 MemoryPointer::MemoryPointer(Memory& memory, uint16_t address)
 {
 	Memory::MemoryRange* range = memory.FindMemoryRange(address);
@@ -28,7 +13,7 @@ MemoryPointer::MemoryPointer(Memory& memory, uint16_t address)
 	localAddress = address - range->start;
 }
 
-uint8_t MemoryPointer::Read()
+uint8_t MemoryPointer::Read() const
 {
 	return memoryBank->ReadByte(localAddress);
 }
@@ -1,12 +1,20 @@
 #include "ringbuffer.h"
 
+#include <string.h>
+
 #include "debug.h"
 
 using namespace libdmg;
 
-RingBuffer::RingBuffer(uint16_t size) : size(size), readOffset(0), writeOffset(0), full(false)
+RingBuffer::RingBuffer(uint32_t size) : readIndex(0), writeIndex(0)
 {
-	data = new uint8_t[size];
+	this->size = 1;
+
+	while (this->size < size)
+		this->size <<= 1;
+
+	mask = this->size - 1;
+	data = new AudioFrame[this->size];
 }
 
 RingBuffer::~RingBuffer()
@@ -18,37 +26,49 @@ RingBuffer::~RingBuffer()
 	}
 }
 
-uint8_t RingBuffer::ReadByte()
+uint32_t RingBuffer::Write(const AudioFrame* frames, uint32_t count)
 {
-	assert(!Empty());
+	uint32_t write = writeIndex.load(std::memory_order_relaxed);
+	uint32_t read = readIndex.load(std::memory_order_acquire);
+
+	count = std::min(count, size - (write - read));
 
-	uint8_t value = data[readOffset];
-	readOffset = (readOffset + 1) % size;
+	// Copy in at most two parts, split where the buffer wraps around
+	uint32_t offset = write & mask;
+	uint32_t firstCount = std::min(count, size - offset);
 
-	full = false;
+	memcpy(data + offset, frames, firstCount * sizeof(AudioFrame));
+	memcpy(data, frames + firstCount, (count - firstCount) * sizeof(AudioFrame));
 
-	return value;
+	// Publish the frames to the consumer
+	writeIndex.store(write + count, std::memory_order_release);
+
+	return count;
 }
 
-void RingBuffer::WriteByte(uint8_t value)
+uint32_t RingBuffer::Read(AudioFrame* frames, uint32_t count)
 {
-	data[writeOffset] = value;
+	uint32_t read = readIndex.load(std::memory_order_relaxed);
+	uint32_t write = writeIndex.load(std::memory_order_acquire);
+
+	count = std::min(count, write - read);
+
+	uint32_t offset = read & mask;
+	uint32_t firstCount = std::min(count, size - offset);
+
+	memcpy(frames, data + offset, firstCount * sizeof(AudioFrame));
+	memcpy(frames + firstCount, data, (count - firstCount) * sizeof(AudioFrame));
 
-	writeOffset = (writeOffset + 1) % size;
+	// Hand the space back to the producer
+	readIndex.store(read + count, std::memory_order_release);
 
-	if (full)
-		readOffset = (readOffset + 1) % size;
-	else
-		full = (writeOffset == readOffset);
+	return count;
 }
 
-uint16_t RingBuffer::Length() const
+uint32_t RingBuffer::Length() const
 {
-	if (full)
-		return size;
+	uint32_t write = writeIndex.load(std::memory_order_acquire);
+	uint32_t read = readIndex.load(std::memory_order_acquire);
 
-	if (writeOffset < readOffset)
-		return (size - readOffset) + writeOffset;
-	else
-		return writeOffset - readOffset;
+	return write - read;
 }
\ No newline at end of file
@@ -3,31 +3,45 @@
 
 #include "environment.h"
 
+#include <atomic>
+
 namespace libdmg
 {
+	// Signed 16 bit stereo sample pair, with the left channel first as interleaved in host audio formats.
+	// The S02 output terminal is the left channel and S01 the right one.
+	struct AudioFrame
+	{
+		int16_t left;
+		int16_t right;
+	};
+
+	// Lock-free ring of audio frames, for a single producer and a single consumer which may run on different threads.
+	// Both indices run freely and are masked on access, the size is rounded up to a power of two.
 	class RingBuffer
 	{
 	
 	private:
 
-		uint8_t* data;
-		uint16_t size;
-		uint16_t readOffset, writeOffset;
+		AudioFrame* data;
+		uint32_t size, mask;
 
-		bool full;
+		// The producer owns the write index and the consumer the read index, both only publish their own
+		std::atomic<uint32_t> readIndex;
+		std::atomic<uint32_t> writeIndex;
 
 	public:
-		RingBuffer(uint16_t size);
+		RingBuffer(uint32_t size);
 		~RingBuffer();
 
-		uint8_t ReadByte();
-		void WriteByte(uint8_t value);
+		// Both return the number of frames transferred, frames that don't fit in the buffer are dropped
+		uint32_t Write(const AudioFrame* frames, uint32_t count);
+		uint32_t Read(AudioFrame* frames, uint32_t count);
 
-		bool Empty() const { return !full && (writeOffset == readOffset); }
-		bool Full() const { return full; }
+		bool Empty() const { return Length() == 0; }
+		bool Full() const { return Length() == size; }
 
-		uint16_t Size() const { return size; }
-		uint16_t Length() const;
+		uint32_t Size() const { return size; }
+		uint32_t Length() const;
 	};
 }
 
@@ -0,0 +1,81 @@
+#include "scheduler.h"
+
+#include "debug.h"
+
+using namespace libdmg;
+
+Scheduler::Scheduler()
+{
+	Reset();
+}
+
+void Scheduler::Reset()
+{
+	for (uint8_t event = 0; event < EVENT_COUNT; ++event)
+	{
+		heap[event] = { NEVER, (Event) event };
+		positions[event] = event;
+	}
+}
+
+void Scheduler::Schedule(Event event, uint64_t ticks)
+{
+	assert(event < EVENT_COUNT);
+
+	uint8_t index = positions[event];
+	uint64_t previousTicks = heap[index].ticks;
+
+	heap[index].ticks = ticks;
+
+	// Move the entry towards the root if its deadline moved forward, or towards the leaves if it was postponed
+	if (ticks < previousTicks)
+		SiftUp(index);
+	else
+		SiftDown(index);
+}
+
+void Scheduler::SiftUp(uint8_t index)
+{
+	while (index > 0)
+	{
+		uint8_t parent = (index - 1) >> 1;
+
+		if (heap[parent].ticks <= heap[index].ticks)
+			break;
+
+		Swap(parent, index);
+		index = parent;
+	}
+}
+
+void Scheduler::SiftDown(uint8_t index)
+{
+	while (true)
+	{
+		uint8_t smallest = index;
+		uint8_t left = (index << 1) + 1;
+		uint8_t right = left + 1;
+
+		if (left < EVENT_COUNT && heap[left].ticks < heap[smallest].ticks)
+			smallest = left;
+
+		if (right < EVENT_COUNT && heap[right].ticks < heap[smallest].ticks)
+			smallest = right;
+
+		if (smallest == index)
+			break;
+
+		Swap(smallest, index);
+		index = smallest;
+	}
+}
+
+void Scheduler::Swap(uint8_t a, uint8_t b)
+{
+	Entry entry = heap[a];
+	heap[a] = heap[b];
+	heap[b] = entry;
+
+	positions[heap[a].event] = a;
+	positions[heap[b].event] = b;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include "environment.h"
+
+namespace libdmg
+{
+	// Min-heap of component deadlines, keyed on the absolute emulator tick.
+	// Every event source owns exactly one slot, rescheduling an event moves its slot in the heap.
+	class Scheduler
+	{
+	public:
+		static const uint64_t NEVER = UINT64_MAX;
+
+		enum Event
+		{
+			EVENT_TIMER = 0,
+			EVENT_VIDEO = 1,
+			EVENT_AUDIO = 2,
+			EVENT_DMA = 3,
+
+			EVENT_COUNT
+		};
+
+	private:
+		struct Entry
+		{
+			uint64_t ticks;
+			Event event;
+		};
+
+		Entry heap[EVENT_COUNT];
+		uint8_t positions[EVENT_COUNT];
+
+	public:
+		Scheduler();
+
+		void Reset();
+		void Schedule(Event event, uint64_t ticks);
+
+		uint64_t NextDeadline() const { return heap[0].ticks; }
+		Event NextEvent() const { return heap[0].event; }
+
+		uint64_t Deadline(Event event) const { return heap[positions[event]].ticks; }
+
+	private:
+		void SiftUp(uint8_t index);
+		void SiftDown(uint8_t index);
+		void Swap(uint8_t a, uint8_t b);
+	};
+}
+
+#endif
\ No newline at end of file
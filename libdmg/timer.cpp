@@ -4,6 +4,7 @@
 
 #include "cpu.h"
 #include "memory.h"
+#include "scheduler.h"
 
 using namespace libdmg;
 
@@ -26,43 +27,78 @@ void Timer::Reset()
 
 void Timer::Sync(const uint64_t& targetTicks)
 {
-	while (ticks < targetTicks)
-		PerformCycle();
-}
+	if (ticks >= targetTicks)
+		return;
+
+	uint64_t elapsedTicks = targetTicks - ticks;
+	ticks = targetTicks;
 
-void Timer::PerformCycle()
-{
 	// DIV register
-	if (++divRegisterCycles == DIV_REGISTER_DIVIDER)
-	{
-		divRegister = *divRegister + 1;
-		divRegisterCycles = 0;
-	}
+	uint64_t divTicks = divRegisterCycles + elapsedTicks;
+	divRegister = (uint8_t) (*divRegister + divTicks / DIV_REGISTER_DIVIDER);
+	divRegisterCycles = (uint16_t) (divTicks % DIV_REGISTER_DIVIDER);
 
 	// Timer
 	uint8_t timerControl = *timerControlRegister;
-	uint16_t timerDivider = TIMER_DIVIDERS[timerControl & 0x3];
 
 	// Check if the timer is enabled
-	if (READ_BIT(timerControl, 2))
+	if (!READ_BIT(timerControl, 2))
+		return;
+
+	uint16_t timerDivider = TIMER_DIVIDERS[timerControl & 0x3];
+
+	uint32_t ticksUntilIncrement = TicksUntilIncrement(timerDivider);
+
+	if (elapsedTicks < ticksUntilIncrement)
+	{
+		timerCycles = (uint16_t) (timerCycles + elapsedTicks);
+		return;
+	}
+
+	// After the first increment the cycle counter restarts at zero every time
+	elapsedTicks -= ticksUntilIncrement;
+
+	uint64_t increments = 1 + elapsedTicks / timerDivider;
+	timerCycles = (uint16_t) (elapsedTicks % timerDivider);
+
+	uint8_t timerCounter = *timerCounterRegister;
+
+	if (increments <= (uint64_t) (0xFF - timerCounter))
 	{
-		// Increment the cycle counter and check if we should increase the counter register
-		if (++timerCycles == timerDivider)
-		{
-			// Increment the counter register and check if it overflowed
-			timerCounterRegister = *timerCounterRegister + 1;
-			if (*timerCounterRegister == 0)
-			{
-				// Reset the counter to the timer modulo value
-				timerCounterRegister = *timerModuloRegister;
-
-				// Request the timer interrupt
-				cpu.RequestInterrupt(CPU::INT_TIMER);
-			}
-
-			timerCycles = 0;
-		}
+		timerCounterRegister = (uint8_t) (timerCounter + increments);
+		return;
 	}
 
-	++ticks;
+	// The counter overflowed at least once, after which it is reloaded with the timer modulo value on every overflow.
+	// The interrupt flag is the same for every overflow, the subsystems are synced at the first one through NextEvent.
+	uint8_t timerModulo = *timerModuloRegister;
+	increments -= 0x100 - timerCounter;
+
+	timerCounterRegister = (uint8_t) (timerModulo + increments % (0x100 - timerModulo));
+
+	// Request the timer interrupt
+	cpu.RequestInterrupt(CPU::INT_TIMER);
+}
+
+uint64_t Timer::NextEvent() const
+{
+	uint8_t timerControl = *timerControlRegister;
+
+	// The timer only requests interrupts while it is enabled
+	if (!READ_BIT(timerControl, 2))
+		return Scheduler::NEVER;
+
+	uint16_t timerDivider = TIMER_DIVIDERS[timerControl & 0x3];
+	uint8_t timerCounter = *timerCounterRegister;
+
+	uint32_t ticksUntilIncrement = TicksUntilIncrement(timerDivider);
+
+	// The overflow happens when the counter is incremented past 0xFF
+	return ticks + ticksUntilIncrement + (uint64_t)(0xFF - timerCounter) * timerDivider;
+}
+
+uint32_t Timer::TicksUntilIncrement(uint16_t timerDivider) const
+{
+	// The cycle counter wraps around if the divider was lowered below it
+	return ((uint16_t)(timerDivider - timerCycles - 1)) + 1;
 }
\ No newline at end of file
@@ -33,9 +33,16 @@ namespace libdmg
 		Timer(CPU& cpu, Memory& memory);
 
 		void Reset();
+
+		// Advances DIV and TIMA over any number of ticks at once
 		void Sync(const uint64_t& targetTicks);
-		void PerformCycle();
 
+		// Tick at which TIMA overflows next and requests the timer interrupt
+		uint64_t NextEvent() const;
+
+	private:
+		// Ticks until the counter is incremented next with the given divider
+		uint32_t TicksUntilIncrement(uint16_t timerDivider) const;
 	};
 }
 
@@ -3,6 +3,7 @@
 #include "util.h"
 #include "audio.h"
 #include "memory.h"
+#include "blipbuffer.h"
 #include "debug.h"
 
 using namespace libdmg;
@@ -23,7 +24,7 @@ ToneGenerator::ToneGenerator(bool hasSweep) :
 	wavePatternDuty(2), wavePatternIndex(0),
 	frequency(0), shadowFrequency(0), frequencyTimer(0)
 {
-
+	ResetTerminals();
 }
 
 uint8_t ToneGenerator::ReadByte(uint16_t address) const
@@ -45,6 +46,8 @@ uint8_t ToneGenerator::ReadByte(uint16_t address) const
 		case 0x04:
 			return (lengthCounterEnabled << 6);
 	}
+
+	return 0;
 }
 
 void ToneGenerator::WriteByte(uint16_t address, uint8_t value)
@@ -110,15 +113,68 @@ void ToneGenerator::WriteByte(uint16_t address, uint8_t value)
 	}
 }
 
-void ToneGenerator::StepFrequency()
+void ToneGenerator::Synthesize(BlipBuffer* terminals, const uint8_t* gains, uint32_t time, uint32_t length)
 {
-	--frequencyTimer;
-	
-	if (frequencyTimer == 0)
+	int8_t amplitude = enabled ? volume : 0;
+
+	UpdateTerminals(terminals, gains, time, GetOutput() ? amplitude : -amplitude);
+
+	if (amplitude == 0)
+	{
+		AdvanceFrequency(length);
+		return;
+	}
+
+	// Only the duty cycle steps can change the level, everything else is constant during the block
+	uint32_t period = (2048 - frequency) << 2;
+	uint32_t edge = frequencyTimer > 0 ? frequencyTimer : 0x10000;
+
+	for (; edge <= length; edge += period)
 	{
 		wavePatternIndex = (wavePatternIndex + 1) % 8;
-		frequencyTimer = (2048 - frequency) << 2;
+		UpdateTerminals(terminals, gains, time + edge - 1, GetOutput() ? amplitude : -amplitude);
 	}
+
+	frequencyTimer = (uint16_t) (edge - length);
+}
+
+void ToneGenerator::ResetTerminals()
+{
+	terminalLevels[0] = 0;
+	terminalLevels[1] = 0;
+}
+
+void ToneGenerator::UpdateTerminals(BlipBuffer* terminals, const uint8_t* gains, uint32_t time, int8_t level)
+{
+	for (uint8_t terminal = 0; terminal < 2; ++terminal)
+	{
+		int32_t terminalLevel = level * gains[terminal];
+
+		if (terminalLevel != terminalLevels[terminal])
+		{
+			terminals[terminal].AddDelta(time, terminalLevel - terminalLevels[terminal]);
+			terminalLevels[terminal] = terminalLevel;
+		}
+	}
+}
+
+void ToneGenerator::AdvanceFrequency(uint32_t ticks)
+{
+	// A timer at zero wraps around before it reaches the next edge
+	uint32_t remainingTicks = frequencyTimer > 0 ? frequencyTimer : 0x10000;
+
+	if (ticks < remainingTicks)
+	{
+		frequencyTimer = (uint16_t) (remainingTicks - ticks);
+		return;
+	}
+
+	// After the first edge the timer is reloaded with the same period every time
+	uint32_t period = (2048 - frequency) << 2;
+	ticks -= remainingTicks;
+
+	wavePatternIndex = (wavePatternIndex + 1 + ticks / period) % 8;
+	frequencyTimer = (uint16_t) (period - ticks % period);
 }
 
 void ToneGenerator::StepSweep()
@@ -8,6 +8,7 @@ namespace libdmg
 {
 	class Audio;
 	class Memory;
+	class BlipBuffer;
 
 	class ToneGenerator : public MemoryBank
 	{
@@ -39,13 +40,19 @@ namespace libdmg
 		uint16_t shadowFrequency;
 		uint16_t frequencyTimer;
 
+		// Level last written to each output terminal
+		int32_t terminalLevels[2];
+
 	public:
 		ToneGenerator(bool hasSweep);
 
 		uint8_t ReadByte(uint16_t address) const;
 		void WriteByte(uint16_t address, uint8_t value);
 
-		void StepFrequency();
+		// Runs the frequency timer for a block of ticks, and writes the resulting level changes to the buffer of each output terminal.
+		// The gains scale the channel for every terminal, and may differ from the previous block.
+		void Synthesize(BlipBuffer* terminals, const uint8_t* gains, uint32_t time, uint32_t length);
+		void ResetTerminals();
 
 		void StepSweep();
 		void StepLengthClock();
@@ -57,6 +64,9 @@ namespace libdmg
 		bool Enabled() const { return enabled; }
 
 	private:
+		void AdvanceFrequency(uint32_t ticks);
+		void UpdateTerminals(BlipBuffer* terminals, const uint8_t* gains, uint32_t time, int8_t level);
+
 		void RestartSweep();
 		void UpdateSweepFrequency(bool saveFrequency);
 	};
@@ -1,5 +1,7 @@
 #include "video.h"
 
+#include <string.h>
+
 #include "cpu.h"
 #include "memory.h"
 #include "memorybank.h"
@@ -17,7 +19,10 @@ Video::Video(CPU& cpu, Memory& memory, uint8_t* videoBuffer) :
 	scanline(0), ticks(0), modeTicks(0), currentMode(MODE_VBLANK),
 	lcdControlRegister(memory, GB_REG_LCDC), statRegister(memory, GB_REG_STAT),
 	paletteRegister(memory, GB_REG_BGP), 
-	scanlineRegister(memory, GB_REG_LY), scanlineCompareRegister(memory, GB_REG_LYC)
+	scanlineRegister(memory, GB_REG_LY), scanlineCompareRegister(memory, GB_REG_LYC),
+	scrollXRegister(memory, GB_REG_SCX), scrollYRegister(memory, GB_REG_SCY),
+	windowXRegister(memory, GB_REG_WX), windowYRegister(memory, GB_REG_WY),
+	spritePaletteRegisters{ MemoryPointer(memory, GB_REG_OBP0), MemoryPointer(memory, GB_REG_OBP1) }
 {
 	layerStates[LAYER_BACKGROUND] = true;
 	layerStates[LAYER_WINDOW] = true;
@@ -25,6 +30,45 @@ Video::Video(CPU& cpu, Memory& memory, uint8_t* videoBuffer) :
 
 	Memory::MemoryRange* memoryRange = memory.FindMemoryRange(GB_VRAM);
 	vram = memoryRange->bank;
+	vramData = static_cast<MemoryBuffer*>(vram)->Data();
+
+	for (uint16_t byte = 0; byte < 256; ++byte)
+	{
+		uint8_t flipped = 0;
+
+		for (uint8_t pixel = 0; pixel < 4; ++pixel)
+			flipped |= ((byte >> (pixel << 1)) & 0x03) << ((3 - pixel) << 1);
+
+		flipLUT[byte] = flipped;
+	}
+
+	for (uint16_t tile = 0; tile < GB_TILE_COUNT; ++tile)
+		tileCacheValid[tile] = false;
+
+	UpdatePaletteLUT(0xE4);
+
+	Memory::MemoryRange* oamRange = memory.FindMemoryRange(GB_OAM);
+	oam = static_cast<MemoryBuffer*>(oamRange->bank);
+
+	oamDirty = true;
+	lineSpriteCount = 0;
+
+	memory.BindVideoMemoryListener(this);
+
+	outputBuffer = NULL;
+	outputFormat = OUTPUT_INDEXED8;
+	outputPitch = 0;
+
+	const uint32_t defaultPalette[] = { 0, 1, 2, 3 };
+	SetOutputPalette(defaultPalette);
+
+	renderPolicy = RENDER_ALL;
+	skippedFrames = 0;
+	skipPeriod = 1;
+	frameCount = 0;
+
+	renderFrame = true;
+	frameRequested = false;
 }
 
 void Video::Reset()
@@ -33,12 +77,86 @@ void Video::Reset()
 	modeTicks = 0;
 	scanline = 0;
 	currentMode = MODE_VBLANK;
+
+	lineSpriteCount = 0;
+
+	frameCount = 0;
+	renderFrame = true;
 }
 
 void Video::Sync(const uint64_t& targetTicks)
 {
 	while (ticks < targetTicks)
-		Step();
+	{
+		uint64_t eventTicks = NextEvent();
+
+		if (eventTicks > targetTicks)
+		{
+			// Nothing happens before the target, only the mode timer advances
+			modeTicks += (uint16_t)(targetTicks - ticks);
+			ticks = targetTicks;
+		}
+		else
+		{
+			// Skip ahead to the step that triggers the next event
+			modeTicks += (uint16_t)(eventTicks - 1 - ticks);
+			ticks = eventTicks - 1;
+
+			Step();
+		}
+	}
+}
+
+uint64_t Video::NextEvent() const
+{
+	switch (currentMode)
+	{
+		case MODE_HBLANK:
+			return ticks + (GB_HBLANK_DURATION - modeTicks);
+
+		case MODE_VBLANK:
+		{
+			// The scanline is increased on every 500th tick of the VBlank, the mode ends on its last tick
+			uint16_t nextScanlineTicks = modeTicks > 0 ? ((modeTicks + 499) / 500) * 500 : 500;
+			uint16_t eventModeTicks = std::min(nextScanlineTicks, (uint16_t)(GB_VBLANK_DURATION - 1));
+
+			return ticks + (eventModeTicks - modeTicks) + 1;
+		}
+
+		case MODE_SEARCHING_OAM:
+			return ticks + (GB_SEARCH_OAM_DURATION - modeTicks);
+
+		case MODE_TRANSFERRING_DATA:
+			return ticks + (GB_TRANSFER_DATA_DURATION - modeTicks);
+	}
+
+	return ticks + 1;
+}
+
+uint64_t Video::NextInterrupt() const
+{
+	// STAT interrupts can be requested on any mode or scanline change
+	uint8_t stat = *statRegister;
+
+	if (READ_BIT(stat, STAT_HBLANK_INTERRUPT) || READ_BIT(stat, STAT_SEARCH_OAM_INTERRUPT) || READ_BIT(stat, STAT_LYC_INTERRUPT))
+		return NextEvent();
+
+	// Otherwise only the start of the VBlank requests an interrupt
+	const uint32_t lineDuration = GB_SEARCH_OAM_DURATION + GB_TRANSFER_DATA_DURATION + GB_HBLANK_DURATION;
+	const uint32_t vblankStart = GB_SCREEN_HEIGHT * lineDuration;
+	
+	if (currentMode == MODE_VBLANK)
+		return ticks + (GB_VBLANK_DURATION - modeTicks) + vblankStart;
+
+	// Position of the current tick within the visible part of the frame
+	uint32_t lineTicks = modeTicks;
+
+	if (currentMode == MODE_TRANSFERRING_DATA)
+		lineTicks += GB_SEARCH_OAM_DURATION;
+	else if (currentMode == MODE_HBLANK)
+		lineTicks += GB_SEARCH_OAM_DURATION + GB_TRANSFER_DATA_DURATION;
+
+	return ticks + (vblankStart - (scanline * lineDuration + lineTicks));
 }
 
 void Video::Step()
@@ -66,6 +184,7 @@ void Video::Step()
 			if (++modeTicks == GB_VBLANK_DURATION)
 			{
 				scanline = 0;
+				BeginFrame();
 				SwitchMode(MODE_SEARCHING_OAM);
 			}
 			break;
@@ -73,7 +192,12 @@ void Video::Step()
 		case MODE_SEARCHING_OAM:
 
 			if (++modeTicks == GB_SEARCH_OAM_DURATION)
+			{
+				if (renderFrame)
+					SearchOAM();
+
 				SwitchMode(MODE_TRANSFERRING_DATA);
+			}
 
 			break;
 
@@ -81,7 +205,9 @@ void Video::Step()
 
 			if (++modeTicks == GB_TRANSFER_DATA_DURATION)
 			{
-				DrawLine();
+				if (renderFrame)
+					DrawLine();
+
 				SwitchMode(MODE_HBLANK);
 			}
 
@@ -91,27 +217,66 @@ void Video::Step()
 	++ticks;
 }
 
+void Video::BeginFrame()
+{
+	switch (renderPolicy)
+	{
+		case RENDER_ALL:
+			renderFrame = true;
+			break;
+
+		case RENDER_SKIP_FRAMES:
+			renderFrame = (frameCount % skipPeriod) >= skippedFrames;
+			break;
+
+		case RENDER_NONE:
+			renderFrame = false;
+			break;
+
+		case RENDER_ON_REQUEST:
+			renderFrame = frameRequested;
+			frameRequested = false;
+			break;
+	}
+
+	++frameCount;
+}
+
+void Video::SetFrameSkip(uint8_t skippedFrames, uint8_t period)
+{
+	assert(period > 0 && skippedFrames < period);
+
+	renderPolicy = RENDER_SKIP_FRAMES;
+	this->skippedFrames = skippedFrames;
+	skipPeriod = period;
+	frameCount = 0;
+}
+
 void Video::DrawTileset()
 {
-	uint16_t tileAddress = GB_TILE_DATA_0;
-	uint8_t tileBuffer[GB_TILE_SIZE];
+	const uint16_t tileCount = 256;
 
 	memset(videoBuffer, 0, GB_SCREEN_WIDTH * GB_SCREEN_HEIGHT / 4);
 
-	for (uint16_t tileIdx = 0; tileIdx < 256; ++tileIdx)
+	for (uint16_t tileIdx = 0; tileIdx < tileCount; ++tileIdx)
 	{
 		uint16_t gridX = (tileIdx % 20) * GB_TILE_WIDTH;
 		uint16_t gridY = (tileIdx / 20) * GB_TILE_HEIGHT;
 
-		DecodeTile(tileAddress + tileIdx * GB_TILE_SIZE, tileBuffer);
-
 		for (uint8_t tileY = 0; tileY < GB_TILE_HEIGHT; ++tileY)
 		{
-			videoBuffer[(((gridY + tileY) * GB_SCREEN_WIDTH) + gridX) / 4 + 0] = tileBuffer[tileY * 2 + 0];
-			videoBuffer[(((gridY + tileY) * GB_SCREEN_WIDTH) + gridX) / 4 + 1] = tileBuffer[tileY * 2 + 1];
+			uint16_t tileRow = DecodeTileRow(tileIdx, tileY);
+
+			videoBuffer[(((gridY + tileY) * GB_SCREEN_WIDTH) + gridX) / 4 + 0] = tileRow & 0xFF;
+			videoBuffer[(((gridY + tileY) * GB_SCREEN_WIDTH) + gridX) / 4 + 1] = tileRow >> 8;
 		}
 	}
 
+	if (outputBuffer != NULL)
+	{
+		for (uint8_t line = 0; line < GB_SCREEN_HEIGHT; ++line)
+			WriteOutputLine(line);
+	}
 }
 
 uint8_t Video::GetPixel(uint8_t x, uint8_t y)
@@ -155,8 +320,8 @@ void Video::DrawLine()
 			uint16_t bgMapAddress = READ_BIT(*lcdControlRegister, LCDC_BG_MAP_SELECT) ? GB_BG_MAP_1 : GB_BG_MAP_0;
 			uint16_t bgTileDataAddresss = READ_BIT(*lcdControlRegister, LCDC_BG_DATA_SELECT) ? GB_TILE_DATA_0 : GB_TILE_DATA_2;
 
-			uint8_t scrollX = memory.ReadByte(GB_REG_SCX);
-			uint8_t scrollY = memory.ReadByte(GB_REG_SCY);
+			uint8_t scrollX = *scrollXRegister;
+			uint8_t scrollY = *scrollYRegister;
 
 			DrawMap(0, 0, bgMapAddress, bgTileDataAddresss, *paletteRegister, scrollX, scrollY);
 		}
@@ -167,8 +332,8 @@ void Video::DrawLine()
 			uint16_t windowMapAddress = READ_BIT(*lcdControlRegister, LCDC_WINDOW_MAP_SELECT) ? GB_BG_MAP_1 : GB_BG_MAP_0;
 			uint16_t windowTileDataAddresss = READ_BIT(*lcdControlRegister, LCDC_BG_DATA_SELECT) ? GB_TILE_DATA_0 : GB_TILE_DATA_2;
 
-			uint8_t offsetX = memory.ReadByte(GB_REG_WX) - 7;
-			uint8_t offsetY = memory.ReadByte(GB_REG_WY);
+			uint8_t offsetX = *windowXRegister - 7;
+			uint8_t offsetY = *windowYRegister;
 
 			if (offsetX < GB_SCREEN_WIDTH && offsetY < GB_SCREEN_HEIGHT && scanline >= offsetY)
 				DrawMap(offsetX, offsetY, windowMapAddress, windowTileDataAddresss, *paletteRegister, 0, 0);
@@ -179,6 +344,9 @@ void Video::DrawLine()
 
 	if (layerStates[LAYER_SPRITES] && READ_BIT(*lcdControlRegister, LCDC_SPRITE_ENABLE))
 		DrawSprites();
+
+	if (outputBuffer != NULL)
+		WriteOutputLine(scanline);
 }
 
 void Video::DrawMap(uint8_t offsetX, uint8_t offsetY, uint16_t mapAddress, uint16_t tileDataAddress, uint8_t palette, uint8_t scrollX, uint8_t scrollY)
@@ -189,50 +357,176 @@ void Video::DrawMap(uint8_t offsetX, uint8_t offsetY, uint16_t mapAddress, uint1
 
 	bool signedTileIndices = tileDataAddress == GB_TILE_DATA_2;
 
-	for (uint8_t x = offsetX; x < GB_SCREEN_WIDTH; ++x)
+	if (palette != paletteLUTPalette)
+		UpdatePaletteLUT(palette);
+
+	uint16_t mapRowAddress = mapAddress - GB_VRAM + tileY * (GB_BG_WIDTH / GB_TILE_WIDTH);
+	uint8_t mapTileX = scrollX / GB_TILE_WIDTH;
+
+	// Pixels of the first tile that are scrolled out of view
+	uint8_t skippedPixels = scrollX % GB_TILE_WIDTH;
+	uint8_t tileCount = (GB_SCREEN_WIDTH - offsetX + skippedPixels + GB_TILE_WIDTH - 1) / GB_TILE_WIDTH;
+
+	uint8_t* line = videoBuffer + scanline * (GB_SCREEN_WIDTH / 4);
+	uint8_t* lineEnd = line + (GB_SCREEN_WIDTH / 4);
+	uint8_t* output = line + offsetX / 4;
+
+	// Pixels are collected in a shift register and written to the video buffer 4 at a time.
+	// When the map starts halfway a video byte, the pixels left of it are preserved.
+	uint8_t pixelCount = offsetX % 4;
+	uint32_t pixels = *output & ((1 << (pixelCount << 1)) - 1);
+
+	for (uint8_t tile = 0; tile < tileCount; ++tile)
 	{
-		uint8_t mapX = ((scrollX + x - offsetX) % GB_BG_WIDTH);
-		uint8_t tileX = mapX / GB_TILE_WIDTH;
+		// Read the index of the tile to use for the next 8 pixels
+		uint8_t tileIdx = vramData[mapRowAddress + ((mapTileX + tile) % (GB_BG_WIDTH / GB_TILE_WIDTH))];
 
-		// Read the index of the tile to use for this pixel
-		uint8_t tileIdx = vram->ReadByte(mapAddress - GB_VRAM + tileY * (GB_BG_WIDTH / GB_TILE_WIDTH) + tileX);
-	
-		uint8_t tileLocalX = mapX % GB_TILE_WIDTH;
+		// Signed indices address the tiles around the start of the third block
+		uint16_t cacheTile = signedTileIndices ? (uint16_t) (256 + DECODE_SIGNED_BYTE(&tileIdx)) : tileIdx;
+		uint16_t tileRow = DecodeTileRow(cacheTile, tileLocalY);
 
-		uint16_t tileAddress = tileDataAddress; 
-		
-		if (signedTileIndices)
-			tileAddress += GB_TILE_SIZE * DECODE_SIGNED_BYTE(&tileIdx);
-		else
-			tileAddress += GB_TILE_SIZE * tileIdx;
+		// Retrieve the colors from the palette
+		tileRow = paletteLUT[tileRow & 0xFF] | (paletteLUT[tileRow >> 8] << 8);
+
+		pixels |= (uint32_t) (tileRow >> (skippedPixels << 1)) << (pixelCount << 1);
+		pixelCount += GB_TILE_WIDTH - skippedPixels;
 
-		uint8_t tilePixel;
-		DecodeTile(tileAddress, tileLocalY, tileLocalX, tilePixel);
+		skippedPixels = 0;
 
-		// Retrieve the color from the palette
-		uint8_t color = (palette >> (tilePixel << 1)) & 0x03;
-		
-		SetPixel(x, scanline, color);
+		while (pixelCount >= 4 && output < lineEnd)
+		{
+			*output++ = (uint8_t) pixels;
+
+			pixels >>= 8;
+			pixelCount -= 4;
+		}
 	}
 }
 
-void Video::DrawSprites()
+void Video::SetOutputBuffer(uint8_t* buffer, OutputFormat format, int32_t pitch)
+{
+	outputBuffer = buffer;
+	outputFormat = format;
+	outputPitch = pitch;
+
+	UpdateOutputLUT();
+}
+
+void Video::SetOutputPalette(const uint32_t* colors)
+{
+	for (uint8_t color = 0; color < 4; ++color)
+		outputPalette[color] = colors[color];
+
+	UpdateOutputLUT();
+}
+
+void Video::UpdateOutputLUT()
+{
+	for (uint16_t byte = 0; byte < 256; ++byte)
+	{
+		for (uint8_t pixel = 0; pixel < 4; ++pixel)
+		{
+			uint32_t color = outputPalette[(byte >> (pixel << 1)) & 0x03];
+
+			switch (outputFormat)
+			{
+				case OUTPUT_INDEXED8:
+					outputLUT[byte][pixel] = (uint8_t) color;
+					break;
+
+				case OUTPUT_RGB565:
+				{
+					uint16_t color565 = (uint16_t) color;
+					memcpy(&outputLUT[byte][pixel * sizeof(uint16_t)], &color565, sizeof(uint16_t));
+					break;
+				}
+
+				case OUTPUT_BGRA32:
+					memcpy(&outputLUT[byte][pixel * sizeof(uint32_t)], &color, sizeof(uint32_t));
+					break;
+			}
+		}
+	}
+}
+
+void Video::WriteOutputLine(uint8_t line)
+{
+	const uint8_t* input = videoBuffer + line * (GB_SCREEN_WIDTH / 4);
+	uint8_t* output = outputBuffer + line * outputPitch;
+
+	// Every packed byte is converted to 4 host pixels with a single lookup
+	switch (outputFormat)
+	{
+		case OUTPUT_INDEXED8:
+			for (uint8_t byte = 0; byte < GB_SCREEN_WIDTH / 4; ++byte)
+				memcpy(output + byte * 4 * sizeof(uint8_t), outputLUT[input[byte]], 4 * sizeof(uint8_t));
+			break;
+
+		case OUTPUT_RGB565:
+			for (uint8_t byte = 0; byte < GB_SCREEN_WIDTH / 4; ++byte)
+				memcpy(output + byte * 4 * sizeof(uint16_t), outputLUT[input[byte]], 4 * sizeof(uint16_t));
+			break;
+
+		case OUTPUT_BGRA32:
+			for (uint8_t byte = 0; byte < GB_SCREEN_WIDTH / 4; ++byte)
+				memcpy(output + byte * 4 * sizeof(uint32_t), outputLUT[input[byte]], 4 * sizeof(uint32_t));
+			break;
+	}
+}
+
+void Video::SearchOAM()
 {
-	uint8_t spriteBuffer[sizeof(Sprite)];
-	const Sprite* sprite = (Sprite*)&spriteBuffer[0];
+	if (oamDirty)
+	{
+		memcpy(oamSnapshot, oam->Data(), sizeof(oamSnapshot));
+		oamDirty = false;
+	}
 
+	uint8_t height = GB_TILE_HEIGHT << (READ_BIT(*lcdControlRegister, LCDC_SPRITE_SIZE) ? 1 : 0);
+
+	lineSpriteCount = 0;
+
+	// Only the first sprites in OAM order that overlap the scanline are drawn
+	for (uint8_t spriteIdx = 0; spriteIdx < GB_MAX_SPRITES && lineSpriteCount < GB_MAX_LINE_SPRITES; ++spriteIdx)
+	{
+		const Sprite& sprite = oamSnapshot[spriteIdx];
+		int16_t minY = sprite.y - (GB_TILE_HEIGHT << 1);
+
+		if (scanline < minY || scanline >= minY + height)
+			continue;
+
+		// Sprites with a lower X coordinate have priority, sprites at the same X are ordered by OAM index
+		uint8_t insertIdx = lineSpriteCount;
+
+		while (insertIdx > 0 && oamSnapshot[lineSprites[insertIdx - 1]].x > sprite.x)
+		{
+			lineSprites[insertIdx] = lineSprites[insertIdx - 1];
+			--insertIdx;
+		}
+
+		lineSprites[insertIdx] = spriteIdx;
+		++lineSpriteCount;
+	}
+}
+
+void Video::DrawSprites()
+{
 	bool doubleSize = READ_BIT(*lcdControlRegister, LCDC_SPRITE_SIZE);
 	uint8_t height = GB_TILE_HEIGHT << (doubleSize ? 1 : 0);
 
-	for (uint8_t spriteIdx = 0; spriteIdx < GB_MAX_SPRITES; ++spriteIdx)
+	// Pixels that are already covered by a sprite with a higher priority
+	bool coveredPixels[GB_SCREEN_WIDTH];
+	memset(coveredPixels, 0, sizeof(coveredPixels));
+
+	for (uint8_t lineSpriteIdx = 0; lineSpriteIdx < lineSpriteCount; ++lineSpriteIdx)
 	{
-		memory.ReadBuffer(&spriteBuffer[0], GB_OAM + spriteIdx * sizeof(Sprite), sizeof(Sprite));
+		const Sprite* sprite = &oamSnapshot[lineSprites[lineSpriteIdx]];
 
 		int16_t minY = sprite->y - (GB_TILE_HEIGHT << 1);
 		int16_t maxY = minY + height - 1;
 
-		// Test if this sprite overlaps this scanline
-		if (scanline < minY || scanline > maxY)
+		// The sprite size can change between the OAM search and drawing
+		if (scanline > maxY)
 			continue;
 
 		// Read sprite attribute flags
@@ -257,84 +551,80 @@ void Video::DrawSprites()
 				tileIdx &= 0xFE;
 		}
 
-		// Read the tile data for this sprite
-		uint8_t tileBuffer[2];
-		DecodeTile(GB_TILE_DATA_0 + GB_TILE_SIZE * tileIdx, tileY, tileBuffer);
+		// Read the tile data for this sprite, mirrored if needed
+		uint16_t tileRow = DecodeTileRow(tileIdx, tileY, flipX);
 
 		// Read the palette to use
-		uint8_t palette = memory.ReadByte(READ_BIT(sprite->flags, SPRITE_PALETTE) ? GB_REG_OBP1 : GB_REG_OBP0);
+		uint8_t palette = *spritePaletteRegisters[READ_BIT(sprite->flags, SPRITE_PALETTE) ? 1 : 0];
 
 		for (uint8_t tileX = 0; tileX < GB_TILE_WIDTH; ++tileX)
 		{
 			int16_t x = sprite->x - GB_TILE_WIDTH + tileX;
 
-			if (x < 0 || x >= GB_SCREEN_WIDTH)
+			if (x < 0 || x >= GB_SCREEN_WIDTH || coveredPixels[x])
 				continue;
 
-			// Check if we need to render the sprite above or below the background
-			uint8_t color;
-
-			if (behindBackground)
-			{
-				color = GetPixel((uint8_t) x, scanline);
-
-				if (color > 0)
-					continue;
-			}
+			// Retrieve the 2 bit palette color index from the tile row
+			uint8_t paletteColorIdx = (tileRow >> (tileX << 1)) & 0x03;
 
-			// Read the tile data byte
-			uint8_t tilePixelOffset = flipX ? (GB_TILE_WIDTH - 1 - tileX) : tileX;
-			uint8_t tileData = tileBuffer[tilePixelOffset / 4];
-			uint8_t tileBit = (tilePixelOffset % 4) << 1;
+			if (paletteColorIdx == 0)
+				continue;
 
-			// Retrieve the 2 bit palette color index from the 4 pixel byte
-			uint8_t paletteColorIdx = (tileData >> tileBit) & 0x03;
+			// A sprite pixel hides the pixels of lower priority sprites, even when it is behind the background
+			coveredPixels[x] = true;
 
-			if (paletteColorIdx == 0)
+			// Check if we need to render the sprite above or below the background
+			if (behindBackground && GetPixel((uint8_t) x, scanline) > 0)
 				continue;
 
 			// Retrieve the color from the palette
-			color = (palette >> (paletteColorIdx << 1)) & 0x03;
+			uint8_t color = (palette >> (paletteColorIdx << 1)) & 0x03;
 
 			SetPixel((uint8_t) x, scanline, color);
 		}
 	}
 }
 
-void Video::DecodeTile(uint16_t tileAddress, uint8_t* tileBuffer)
+void Video::UpdateTileCache(uint16_t tile)
 {
-	for (uint8_t tileY = 0; tileY < GB_TILE_HEIGHT; ++tileY)
-		DecodeTile(tileAddress, tileY, tileBuffer + tileY * 2);
-}
+	const uint8_t identityPalette = 0xE4;
 
-void Video::DecodeTile(uint16_t tileAddress, uint8_t tileY, uint8_t* tileBuffer)
-{
-	tileAddress = tileAddress - GB_VRAM + (tileY << 1);
-	uint8_t lowerByte = vram->ReadByte(tileAddress + 0);
-	uint8_t upperByte = vram->ReadByte(tileAddress + 1);
+	// Decode all rows of the tile in one go, the palette is applied when drawing
+	uint16_t rows[GB_TILE_HEIGHT];
+	bitplaneDecoder.Decode(vramData + GB_TILE_DATA_0 - GB_VRAM + tile * GB_TILE_SIZE, rows, GB_TILE_HEIGHT, identityPalette);
 
-	uint8_t leftByte = 0;
-	uint8_t rightByte = 0;
+	uint16_t (*cachedRows)[2] = tileCache + tile * GB_TILE_HEIGHT;
 
-	for (uint8_t pixel = 0; pixel < 4; ++pixel)
+	for (uint8_t tileY = 0; tileY < GB_TILE_HEIGHT; ++tileY)
 	{
-		leftByte |= READ_BIT(lowerByte, 7 - pixel) << ((pixel << 1) + 0);
-		leftByte |= READ_BIT(upperByte, 7 - pixel) << ((pixel << 1) + 1);
-
-		rightByte |= READ_BIT(lowerByte, 3 - pixel) << ((pixel << 1) + 0);
-		rightByte |= READ_BIT(upperByte, 3 - pixel) << ((pixel << 1) + 1);
+		cachedRows[tileY][0] = rows[tileY];
+		cachedRows[tileY][1] = (flipLUT[rows[tileY] & 0xFF] << 8) | flipLUT[rows[tileY] >> 8];
 	}
 
-	tileBuffer[0] = leftByte;
-	tileBuffer[1] = rightByte;
+	tileCacheValid[tile] = true;
 }
-void Video::DecodeTile(uint16_t tileAddress, uint8_t tileY, uint8_t tileX, uint8_t& tilePixel)
+
+void Video::TileDataWritten(uint16_t address)
 {
-	tileAddress = tileAddress - GB_VRAM + (tileY << 1);
-	uint8_t lowerByte = vram->ReadByte(tileAddress + 0);
-	uint8_t upperByte = vram->ReadByte(tileAddress + 1);
+	tileCacheValid[(address - GB_TILE_DATA_0) >> 4] = false;
+}
+
+void Video::UpdatePaletteLUT(uint8_t palette)
+{
+	for (uint16_t byte = 0; byte < 256; ++byte)
+	{
+		uint8_t colors = 0;
+
+		for (uint8_t pixel = 0; pixel < 4; ++pixel)
+		{
+			uint8_t paletteColorIdx = (byte >> (pixel << 1)) & 0x03;
+			colors |= ((palette >> (paletteColorIdx << 1)) & 0x03) << (pixel << 1);
+		}
+
+		paletteLUT[byte] = colors;
+	}
 
-	tilePixel = (READ_BIT(upperByte, 7 - tileX) << 1) | (READ_BIT(lowerByte, 7 - tileX));
+	paletteLUTPalette = palette;
 }
 
 void Video::SwitchMode(Mode mode)
@@ -2,7 +2,10 @@
 #define _VIDEO_CONTROLLER_H_
 
 #include "environment.h"
+#include "gameboy.h"
+#include "memory.h"
 #include "memorypointer.h"
+#include "bitplanedecoder.h"
 
 namespace libdmg
 {
@@ -10,7 +13,7 @@ namespace libdmg
 	class Memory;
 	class MemoryBank;
 
-	class Video
+	class Video : public VideoMemoryListener
 	{
 
 	public:
@@ -29,6 +32,21 @@ namespace libdmg
 			LAYER_SPRITES = 2
 		};
 
+		enum OutputFormat
+		{
+			OUTPUT_INDEXED8 = 0,
+			OUTPUT_RGB565 = 1,
+			OUTPUT_BGRA32 = 2
+		};
+
+		enum RenderPolicy
+		{
+			RENDER_ALL = 0,
+			RENDER_SKIP_FRAMES = 1,
+			RENDER_NONE = 2,
+			RENDER_ON_REQUEST = 3
+		};
+
 		void(*VBlankCallback)();
 
 	private:
@@ -79,8 +97,15 @@ namespace libdmg
 		MemoryPointer paletteRegister;
 		MemoryPointer scanlineRegister;
 		MemoryPointer scanlineCompareRegister;
+		MemoryPointer scrollXRegister;
+		MemoryPointer scrollYRegister;
+		MemoryPointer windowXRegister;
+		MemoryPointer windowYRegister;
+		MemoryPointer spritePaletteRegisters[2];
 
 		MemoryBank* vram;
+		const uint8_t* vramData;
+		MemoryBuffer* oam;
 
 		uint8_t scanline;
 		uint64_t ticks;
@@ -89,6 +114,46 @@ namespace libdmg
 
 		bool layerStates[3];
 
+		// Reverses the order of 4 packed pixels
+		uint8_t flipLUT[256];
+
+		// Decoded rows of every tile in VRAM, regular and flipped horizontally.
+		// Tiles are decoded on first use after their tile data was written.
+		uint16_t tileCache[GB_TILE_COUNT * GB_TILE_HEIGHT][2];
+		bool tileCacheValid[GB_TILE_COUNT];
+
+		// Applies the palette to 4 packed pixels at once
+		uint8_t paletteLUT[256];
+		uint8_t paletteLUTPalette;
+
+		// Copy of the sprite attributes, taken by the first OAM search after they were written
+		Sprite oamSnapshot[GB_MAX_SPRITES];
+		bool oamDirty;
+
+		// Sprites found by the OAM search for the current scanline, from highest to lowest priority
+		uint8_t lineSprites[GB_MAX_LINE_SPRITES];
+		uint8_t lineSpriteCount;
+
+		BitplaneDecoder bitplaneDecoder;
+
+		// Optional frame in a host pixel format, written along with the video buffer
+		uint8_t* outputBuffer;
+		OutputFormat outputFormat;
+		int32_t outputPitch;
+
+		uint32_t outputPalette[4];
+
+		// Host pixels for all combinations of 4 packed pixels
+		uint8_t outputLUT[256][4 * sizeof(uint32_t)];
+
+		// Frames that aren't rendered still run the full mode timing, only the pixel work is skipped
+		RenderPolicy renderPolicy;
+		uint8_t skippedFrames, skipPeriod;
+		uint32_t frameCount;
+
+		bool renderFrame;
+		bool frameRequested;
+
 	public:
 		Video(CPU& cpu, Memory& memory, uint8_t* videoBuffer);
 
@@ -96,25 +161,61 @@ namespace libdmg
 		void Sync(const uint64_t& targetTicks);
 		void DrawTileset();
 
+		uint64_t NextEvent() const;
+		uint64_t NextInterrupt() const;
+
 		void SetLayerState(Layer layer, bool state) { layerStates[layer] = state; }
 		bool GetLayerState(Layer layer) const { return layerStates[layer]; }
 
 		Mode CurrentMode() const { return currentMode; }
 		uint8_t Scanline() const { return scanline; }
+
+		// Renders every scanline into the given buffer as well, the pitch can be negative for bottom-up buffers
+		void SetOutputBuffer(uint8_t* buffer, OutputFormat format, int32_t pitch);
+		
+		// Colors for the 4 shades, encoded in the output format
+		void SetOutputPalette(const uint32_t* colors);
+
+		void SetRenderPolicy(RenderPolicy policy) { renderPolicy = policy; }
+		RenderPolicy GetRenderPolicy() const { return renderPolicy; }
+
+		// Skips the given number of frames out of every period
+		void SetFrameSkip(uint8_t skippedFrames, uint8_t period);
+
+		// Renders the next frame when using RENDER_ON_REQUEST
+		void RequestFrame() { frameRequested = true; }
+
+		// Whether the current frame is being drawn, in the VBlank callback this refers to the frame that just finished
+		bool IsFrameRendered() const { return renderFrame; }
+
 	private:
 		void Step();
+		void BeginFrame();
 
 		void DrawLine();
 
 		void DrawMap(uint8_t offsetX, uint8_t offsetY, uint16_t mapAddress, uint16_t tileDataAddress, uint8_t palette, uint8_t scrollX, uint8_t scrollY);
+		void SearchOAM();
+		void WriteOutputLine(uint8_t line);
+		void UpdateOutputLUT();
 		void DrawSprites();
 
 		uint8_t GetPixel(uint8_t x, uint8_t y);
 		void SetPixel(uint8_t x, uint8_t y, uint8_t color);
 
-		void DecodeTile(uint16_t tileAddress, uint8_t* tileBuffer);
-		void DecodeTile(uint16_t tileAddress, uint8_t tileY, uint8_t* tileBuffer);
-		void DecodeTile(uint16_t tileAddress, uint8_t tileY, uint8_t tileX, uint8_t& tilePixel);
+		// Tiles are numbered from the start of the tile data, rows have the leftmost pixel in the lowest bits
+		DMG_INLINE uint16_t DecodeTileRow(uint16_t tile, uint8_t tileY, bool flipX = false)
+		{
+			if (!tileCacheValid[tile])
+				UpdateTileCache(tile);
+
+			return tileCache[tile * GB_TILE_HEIGHT + tileY][flipX ? 1 : 0];
+		}
+
+		void UpdateTileCache(uint16_t tile);
+		void UpdatePaletteLUT(uint8_t palette);
+		void TileDataWritten(uint16_t address);
+		void OAMWritten() { oamDirty = true; }
 
 		void SwitchMode(Mode mode);
 		void SetScanline(uint8_t scanline);
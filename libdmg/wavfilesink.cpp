@@ -0,0 +1,100 @@
+#include "wavfilesink.h"
+
+#include <string.h>
+
+#include "util.h"
+#include "debug.h"
+
+using namespace libdmg;
+
+WavFileSink::WavFileSink(const char* fileName) : fileName(fileName), file(NULL), frequency(0), frameCount(0)
+{
+
+}
+
+WavFileSink::~WavFileSink()
+{
+	Close();
+}
+
+uint32_t WavFileSink::Open(uint32_t preferredFrequency, uint32_t latency)
+{
+	file = fopen(fileName, "wb");
+
+	if (file == NULL)
+	{
+		Debug::Print("[WavFileSink]: Failed to open %s for writing.\n", fileName);
+		return 0;
+	}
+
+	frequency = preferredFrequency;
+	frameCount = 0;
+
+	// Written with empty sizes, which are filled in when the file is closed
+	WriteHeader();
+
+	return frequency;
+}
+
+void WavFileSink::Close()
+{
+	if (file == NULL)
+		return;
+
+	fseek(file, 0, SEEK_SET);
+	WriteHeader();
+
+	fclose(file);
+	file = NULL;
+}
+
+void WavFileSink::Write(const AudioFrame* frames, uint32_t count)
+{
+	frameCount += count;
+
+	uint8_t data[256 * 4];
+
+	while (count > 0)
+	{
+		uint32_t batchCount = std::min(count, (uint32_t) 256);
+
+		for (uint32_t frameIdx = 0; frameIdx < batchCount; ++frameIdx)
+		{
+			WRITE_SSHORT(data + frameIdx * 4 + 0, frames[frameIdx].left);
+			WRITE_SSHORT(data + frameIdx * 4 + 2, frames[frameIdx].right);
+		}
+
+		fwrite(data, 4, batchCount, file);
+
+		frames += batchCount;
+		count -= batchCount;
+	}
+}
+
+void WavFileSink::WriteHeader()
+{
+	const uint16_t channels = 2;
+	const uint16_t bitsPerSample = 16;
+
+	uint32_t dataSize = frameCount * channels * (bitsPerSample / 8);
+
+	uint8_t header[44];
+
+	memcpy(header + 0, "RIFF", 4);
+	WRITE_LONG(header + 4, 36 + dataSize);
+	memcpy(header + 8, "WAVE", 4);
+
+	memcpy(header + 12, "fmt ", 4);
+	WRITE_LONG(header + 16, 16);
+	WRITE_SHORT(header + 20, 1);
+	WRITE_SHORT(header + 22, channels);
+	WRITE_LONG(header + 24, frequency);
+	WRITE_LONG(header + 28, frequency * channels * (bitsPerSample / 8));
+	WRITE_SHORT(header + 32, channels * (bitsPerSample / 8));
+	WRITE_SHORT(header + 34, bitsPerSample);
+
+	memcpy(header + 36, "data", 4);
+	WRITE_LONG(header + 40, dataSize);
+
+	fwrite(header, sizeof(header), 1, file);
+}
\ No newline at end of file
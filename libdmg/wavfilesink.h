@@ -0,0 +1,37 @@
+#ifndef _WAV_FILE_SINK_H_
+#define _WAV_FILE_SINK_H_
+
+#include "audiosink.h"
+
+#include <cstdio>
+
+namespace libdmg
+{
+	// Writes the output to a 16 bit stereo PCM wave file
+	class WavFileSink : public AudioSink
+	{
+	private:
+		const char* fileName;
+		FILE* file;
+
+		uint32_t frequency;
+		uint32_t frameCount;
+
+	public:
+		WavFileSink(const char* fileName);
+		~WavFileSink();
+
+		uint32_t Open(uint32_t preferredFrequency, uint32_t latency);
+		void Close();
+
+		uint32_t Writable() { return UINT32_MAX; }
+		void Write(const AudioFrame* frames, uint32_t count);
+
+		bool IsRealTime() const { return false; }
+
+	private:
+		void WriteHeader();
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+// ringbuffertest.cpp : Streams frames from a producer thread to a consumer thread through the ring buffer, in chunks of random sizes.
+//
+
+#include "ringbuffer.h"
+
+#include <stdio.h>
+
+#include <random>
+#include <thread>
+
+#define BUFFER_SIZE 1000
+#define FRAME_COUNT 2000000
+#define MAX_WRITE_CHUNK 97
+#define MAX_READ_CHUNK 61
+
+using namespace libdmg;
+
+void Produce(RingBuffer* buffer)
+{
+	// Each thread has its own generator, with a fixed seed so the chunk sizes are the same on every run
+	std::minstd_rand random(1);
+
+	AudioFrame frames[MAX_WRITE_CHUNK];
+	uint32_t written = 0;
+
+	while (written < FRAME_COUNT)
+	{
+		uint32_t count = 1 + random() % MAX_WRITE_CHUNK;
+
+		if (count > FRAME_COUNT - written)
+			count = FRAME_COUNT - written;
+
+		// Every frame carries its own sequence number, so reordered, lost or repeated frames are detected
+		for (uint32_t frameIdx = 0; frameIdx < count; ++frameIdx)
+		{
+			frames[frameIdx].left = (int16_t) (written + frameIdx);
+			frames[frameIdx].right = (int16_t) ~(written + frameIdx);
+		}
+
+		uint32_t transferred = buffer->Write(frames, count);
+		written += transferred;
+
+		if (transferred == 0)
+			std::this_thread::yield();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	RingBuffer buffer(BUFFER_SIZE);
+
+	std::thread producer(Produce, &buffer);
+
+	std::minstd_rand random(2);
+
+	AudioFrame frames[MAX_READ_CHUNK];
+	uint32_t read = 0, errors = 0;
+
+	while (read < FRAME_COUNT)
+	{
+		uint32_t transferred = buffer.Read(frames, 1 + random() % MAX_READ_CHUNK);
+
+		for (uint32_t frameIdx = 0; frameIdx < transferred; ++frameIdx)
+		{
+			if (frames[frameIdx].left != (int16_t) (read + frameIdx) || frames[frameIdx].right != (int16_t) ~(read + frameIdx))
+			{
+				if (errors++ < 5)
+					printf("Frame %u read as (%d, %d)\n", read + frameIdx, frames[frameIdx].left, frames[frameIdx].right);
+			}
+		}
+
+		read += transferred;
+
+		if (transferred == 0)
+			std::this_thread::yield();
+	}
+
+	producer.join();
+
+	if (errors > 0 || !buffer.Empty())
+	{
+		printf("Failed with %u corrupted frames and %u frames left\n", errors, buffer.Length());
+		return 1;
+	}
+
+	printf("Passed\n");
+	return 0;
+}
\ No newline at end of file
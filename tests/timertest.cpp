@@ -0,0 +1,101 @@
+// timertest.cpp : Syncs the timer over random spans and compares it to a reference that counts every tick.
+//
+
+#include "libdmg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ITERATIONS 200000
+
+using namespace libdmg;
+
+const uint16_t TIMER_DIVIDERS[] = { 1024, 16, 64, 256 };
+
+int main(int argc, char** argv)
+{
+	Memory memory;
+	CPU cpu(memory);
+	Timer timer(cpu, memory);
+
+	timer.Reset();
+
+	memory.WriteByte(GB_REG_DIV, 0);
+	memory.WriteByte(GB_REG_TIMA, 0);
+	memory.WriteByte(GB_REG_TAC, 0);
+	memory.WriteByte(GB_REG_TMA, 0);
+
+	// Reference state
+	uint8_t div = 0, timerCounter = 0;
+	uint16_t divCycles = 0, timerCycles = 0;
+
+	uint64_t ticks = 0;
+	uint32_t errors = 0;
+
+	srand(1);
+
+	for (uint32_t iteration = 0; iteration < ITERATIONS; ++iteration)
+	{
+		// Mostly short spans as between instructions, with the occasional long one that overflows many times
+		uint32_t span = rand() % 8 == 0 ? rand() % 300000 : rand() % 2000;
+
+		uint8_t timerControl = memory.ReadByte(GB_REG_TAC);
+		uint8_t timerModulo = memory.ReadByte(GB_REG_TMA);
+		bool overflowed = false;
+
+		for (uint32_t tick = 0; tick < span; ++tick)
+		{
+			if (++divCycles == 256)
+			{
+				++div;
+				divCycles = 0;
+			}
+
+			if (READ_BIT(timerControl, 2) && ++timerCycles == TIMER_DIVIDERS[timerControl & 0x3])
+			{
+				if (++timerCounter == 0)
+				{
+					timerCounter = timerModulo;
+					overflowed = true;
+				}
+
+				timerCycles = 0;
+			}
+		}
+
+		memory.WriteByte(GB_REG_IF, 0);
+
+		ticks += span;
+		timer.Sync(ticks);
+
+		bool interrupt = READ_BIT(memory.ReadByte(GB_REG_IF), CPU::INT_TIMER);
+
+		if (memory.ReadByte(GB_REG_DIV) != div || memory.ReadByte(GB_REG_TIMA) != timerCounter || interrupt != overflowed)
+		{
+			if (errors++ < 5)
+			{
+				printf("Iteration %u over %u ticks: DIV %u/%u, TIMA %u/%u, interrupt %d/%d with TAC 0x%02X and TMA 0x%02X\n", 
+					iteration, span, memory.ReadByte(GB_REG_DIV), div, memory.ReadByte(GB_REG_TIMA), timerCounter, 
+					interrupt, overflowed, timerControl, timerModulo);
+			}
+		}
+
+		// Change the timer configuration between spans, as a program would
+		switch (rand() % 10)
+		{
+			case 0: memory.WriteByte(GB_REG_TAC, (uint8_t) rand()); break;
+			case 1: memory.WriteByte(GB_REG_TMA, (uint8_t) rand()); break;
+			case 2: timerCounter = (uint8_t) rand(); memory.WriteByte(GB_REG_TIMA, timerCounter); break;
+			case 3: memory.WriteByte(GB_REG_TAC, (uint8_t) (rand() % 4 | 4)); break;
+		}
+	}
+
+	if (errors > 0)
+	{
+		printf("Failed in %u of %u iterations\n", errors, ITERATIONS);
+		return 1;
+	}
+
+	printf("Passed\n");
+	return 0;
+}
\ No newline at end of file